@@ -8,9 +8,9 @@
 
 // Ensure the included flatbuffers.h is the same version as when this file was
 // generated, otherwise it may not be compatible.
-static_assert(FLATBUFFERS_VERSION_MAJOR == 24 &&
-              FLATBUFFERS_VERSION_MINOR == 12 &&
-              FLATBUFFERS_VERSION_REVISION == 23,
+static_assert(FLATBUFFERS_VERSION_MAJOR == 25 &&
+              FLATBUFFERS_VERSION_MINOR == 1 &&
+              FLATBUFFERS_VERSION_REVISION == 24,
              "Non-compatible flatbuffers version included");
 
 namespace benchmarks_flatbuffers {
@@ -25,6 +25,17 @@ struct FooBarBuilder;
 struct FooBarContainer;
 struct FooBarContainerBuilder;
 
+struct IdPair;
+
+struct IdEntry;
+struct IdEntryBuilder;
+
+struct NameEntry;
+struct NameEntryBuilder;
+
+struct Dictionary;
+struct DictionaryBuilder;
+
 enum Enum : int16_t {
   Enum_Apples = 0,
   Enum_Pears = 1,
@@ -53,7 +64,7 @@ inline const char * const *EnumNamesEnum() {
 }
 
 inline const char *EnumNameEnum(Enum e) {
-  if (flatbuffers::IsOutRange(e, Enum_Apples, Enum_Bananas)) return "";
+  if (::flatbuffers::IsOutRange(e, Enum_Apples, Enum_Bananas)) return "";
   const size_t index = static_cast<size_t>(e);
   return EnumNamesEnum()[index];
 }
@@ -76,24 +87,24 @@ FLATBUFFERS_MANUALLY_ALIGNED_STRUCT(8) Foo FLATBUFFERS_FINAL_CLASS {
     (void)padding0__;
   }
   Foo(uint64_t _id, int16_t _count, int8_t _prefix, uint32_t _length)
-      : id_(flatbuffers::EndianScalar(_id)),
-        count_(flatbuffers::EndianScalar(_count)),
-        prefix_(flatbuffers::EndianScalar(_prefix)),
+      : id_(::flatbuffers::EndianScalar(_id)),
+        count_(::flatbuffers::EndianScalar(_count)),
+        prefix_(::flatbuffers::EndianScalar(_prefix)),
         padding0__(0),
-        length_(flatbuffers::EndianScalar(_length)) {
+        length_(::flatbuffers::EndianScalar(_length)) {
     (void)padding0__;
   }
   uint64_t id() const {
-    return flatbuffers::EndianScalar(id_);
+    return ::flatbuffers::EndianScalar(id_);
   }
   int16_t count() const {
-    return flatbuffers::EndianScalar(count_);
+    return ::flatbuffers::EndianScalar(count_);
   }
   int8_t prefix() const {
-    return flatbuffers::EndianScalar(prefix_);
+    return ::flatbuffers::EndianScalar(prefix_);
   }
   uint32_t length() const {
-    return flatbuffers::EndianScalar(length_);
+    return ::flatbuffers::EndianScalar(length_);
   }
 };
 FLATBUFFERS_STRUCT_END(Foo, 16);
@@ -119,9 +130,9 @@ FLATBUFFERS_MANUALLY_ALIGNED_STRUCT(8) Bar FLATBUFFERS_FINAL_CLASS {
   }
   Bar(const benchmarks_flatbuffers::Foo &_parent, int32_t _time, float _ratio, uint16_t _size)
       : parent_(_parent),
-        time_(flatbuffers::EndianScalar(_time)),
-        ratio_(flatbuffers::EndianScalar(_ratio)),
-        size_(flatbuffers::EndianScalar(_size)),
+        time_(::flatbuffers::EndianScalar(_time)),
+        ratio_(::flatbuffers::EndianScalar(_ratio)),
+        size_(::flatbuffers::EndianScalar(_size)),
         padding0__(0),
         padding1__(0) {
     (void)padding0__;
@@ -131,18 +142,47 @@ FLATBUFFERS_MANUALLY_ALIGNED_STRUCT(8) Bar FLATBUFFERS_FINAL_CLASS {
     return parent_;
   }
   int32_t time() const {
-    return flatbuffers::EndianScalar(time_);
+    return ::flatbuffers::EndianScalar(time_);
   }
   float ratio() const {
-    return flatbuffers::EndianScalar(ratio_);
+    return ::flatbuffers::EndianScalar(ratio_);
   }
   uint16_t size() const {
-    return flatbuffers::EndianScalar(size_);
+    return ::flatbuffers::EndianScalar(size_);
   }
 };
 FLATBUFFERS_STRUCT_END(Bar, 32);
 
-struct FooBar FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+FLATBUFFERS_MANUALLY_ALIGNED_STRUCT(8) IdPair FLATBUFFERS_FINAL_CLASS {
+ private:
+  uint64_t id_;
+  uint64_t value_;
+
+ public:
+  IdPair()
+      : id_(0),
+        value_(0) {
+  }
+  IdPair(uint64_t _id, uint64_t _value)
+      : id_(::flatbuffers::EndianScalar(_id)),
+        value_(::flatbuffers::EndianScalar(_value)) {
+  }
+  uint64_t id() const {
+    return ::flatbuffers::EndianScalar(id_);
+  }
+  bool KeyCompareLessThan(const IdPair * const o) const {
+    return id() < o->id();
+  }
+  int KeyCompareWithValue(uint64_t _id) const {
+    return static_cast<int>(id() > _id) - static_cast<int>(id() < _id);
+  }
+  uint64_t value() const {
+    return ::flatbuffers::EndianScalar(value_);
+  }
+};
+FLATBUFFERS_STRUCT_END(IdPair, 16);
+
+struct FooBar FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
   typedef FooBarBuilder Builder;
   enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
     VT_SIBLING = 4,
@@ -153,8 +193,8 @@ struct FooBar FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   const benchmarks_flatbuffers::Bar *sibling() const {
     return GetStruct<const benchmarks_flatbuffers::Bar *>(VT_SIBLING);
   }
-  const flatbuffers::String *name() const {
-    return GetPointer<const flatbuffers::String *>(VT_NAME);
+  const ::flatbuffers::String *name() const {
+    return GetPointer<const ::flatbuffers::String *>(VT_NAME);
   }
   double rating() const {
     return GetField<double>(VT_RATING, 0.0);
@@ -162,7 +202,27 @@ struct FooBar FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   uint8_t postfix() const {
     return GetField<uint8_t>(VT_POSTFIX, 0);
   }
-  bool Verify(flatbuffers::Verifier &verifier) const {
+  // Reads fields without going through the vtable each time, see
+  // ::flatbuffers::TableView.
+  class View : private ::flatbuffers::TableView<4> {
+   public:
+    explicit View(const FooBar *table)
+        : ::flatbuffers::TableView<4>(table) {}
+    const benchmarks_flatbuffers::Bar *sibling() const {
+      return GetStruct<const benchmarks_flatbuffers::Bar *>(VT_SIBLING);
+    }
+    const ::flatbuffers::String *name() const {
+      return GetPointer<const ::flatbuffers::String *>(VT_NAME);
+    }
+    double rating() const {
+      return GetField<double>(VT_RATING, 0.0);
+    }
+    uint8_t postfix() const {
+      return GetField<uint8_t>(VT_POSTFIX, 0);
+    }
+  };
+  View GetView() const { return View(this); }
+  bool Verify(::flatbuffers::Verifier &verifier) const {
     return VerifyTableStart(verifier) &&
            VerifyField<benchmarks_flatbuffers::Bar>(verifier, VT_SIBLING, 8) &&
            VerifyOffset(verifier, VT_NAME) &&
@@ -175,12 +235,12 @@ struct FooBar FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
 
 struct FooBarBuilder {
   typedef FooBar Table;
-  flatbuffers::FlatBufferBuilder &fbb_;
-  flatbuffers::uoffset_t start_;
+  ::flatbuffers::FlatBufferBuilder &fbb_;
+  ::flatbuffers::uoffset_t start_;
   void add_sibling(const benchmarks_flatbuffers::Bar *sibling) {
     fbb_.AddStruct(FooBar::VT_SIBLING, sibling);
   }
-  void add_name(flatbuffers::Offset<flatbuffers::String> name) {
+  void add_name(::flatbuffers::Offset<::flatbuffers::String> name) {
     fbb_.AddOffset(FooBar::VT_NAME, name);
   }
   void add_rating(double rating) {
@@ -189,21 +249,21 @@ struct FooBarBuilder {
   void add_postfix(uint8_t postfix) {
     fbb_.AddElement<uint8_t>(FooBar::VT_POSTFIX, postfix, 0);
   }
-  explicit FooBarBuilder(flatbuffers::FlatBufferBuilder &_fbb)
+  explicit FooBarBuilder(::flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
     start_ = fbb_.StartTable();
   }
-  flatbuffers::Offset<FooBar> Finish() {
+  ::flatbuffers::Offset<FooBar> Finish() {
     const auto end = fbb_.EndTable(start_);
-    auto o = flatbuffers::Offset<FooBar>(end);
+    auto o = ::flatbuffers::Offset<FooBar>(end);
     return o;
   }
 };
 
-inline flatbuffers::Offset<FooBar> CreateFooBar(
-    flatbuffers::FlatBufferBuilder &_fbb,
+inline ::flatbuffers::Offset<FooBar> CreateFooBar(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
     const benchmarks_flatbuffers::Bar *sibling = nullptr,
-    flatbuffers::Offset<flatbuffers::String> name = 0,
+    ::flatbuffers::Offset<::flatbuffers::String> name = 0,
     double rating = 0.0,
     uint8_t postfix = 0) {
   FooBarBuilder builder_(_fbb);
@@ -214,8 +274,8 @@ inline flatbuffers::Offset<FooBar> CreateFooBar(
   return builder_.Finish();
 }
 
-inline flatbuffers::Offset<FooBar> CreateFooBarDirect(
-    flatbuffers::FlatBufferBuilder &_fbb,
+inline ::flatbuffers::Offset<FooBar> CreateFooBarDirect(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
     const benchmarks_flatbuffers::Bar *sibling = nullptr,
     const char *name = nullptr,
     double rating = 0.0,
@@ -229,7 +289,7 @@ inline flatbuffers::Offset<FooBar> CreateFooBarDirect(
       postfix);
 }
 
-struct FooBarContainer FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+struct FooBarContainer FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
   typedef FooBarContainerBuilder Builder;
   enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
     VT_LIST = 4,
@@ -237,8 +297,8 @@ struct FooBarContainer FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
     VT_FRUIT = 8,
     VT_LOCATION = 10
   };
-  const flatbuffers::Vector<flatbuffers::Offset<benchmarks_flatbuffers::FooBar>> *list() const {
-    return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<benchmarks_flatbuffers::FooBar>> *>(VT_LIST);
+  const ::flatbuffers::Vector<::flatbuffers::Offset<benchmarks_flatbuffers::FooBar>> *list() const {
+    return GetPointer<const ::flatbuffers::Vector<::flatbuffers::Offset<benchmarks_flatbuffers::FooBar>> *>(VT_LIST);
   }
   bool initialized() const {
     return GetField<uint8_t>(VT_INITIALIZED, 0) != 0;
@@ -246,10 +306,30 @@ struct FooBarContainer FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   benchmarks_flatbuffers::Enum fruit() const {
     return static_cast<benchmarks_flatbuffers::Enum>(GetField<int16_t>(VT_FRUIT, 0));
   }
-  const flatbuffers::String *location() const {
-    return GetPointer<const flatbuffers::String *>(VT_LOCATION);
-  }
-  bool Verify(flatbuffers::Verifier &verifier) const {
+  const ::flatbuffers::String *location() const {
+    return GetPointer<const ::flatbuffers::String *>(VT_LOCATION);
+  }
+  // Reads fields without going through the vtable each time, see
+  // ::flatbuffers::TableView.
+  class View : private ::flatbuffers::TableView<4> {
+   public:
+    explicit View(const FooBarContainer *table)
+        : ::flatbuffers::TableView<4>(table) {}
+    const ::flatbuffers::Vector<::flatbuffers::Offset<benchmarks_flatbuffers::FooBar>> *list() const {
+      return GetPointer<const ::flatbuffers::Vector<::flatbuffers::Offset<benchmarks_flatbuffers::FooBar>> *>(VT_LIST);
+    }
+    bool initialized() const {
+      return GetField<uint8_t>(VT_INITIALIZED, 0) != 0;
+    }
+    benchmarks_flatbuffers::Enum fruit() const {
+      return static_cast<benchmarks_flatbuffers::Enum>(GetField<int16_t>(VT_FRUIT, 0));
+    }
+    const ::flatbuffers::String *location() const {
+      return GetPointer<const ::flatbuffers::String *>(VT_LOCATION);
+    }
+  };
+  View GetView() const { return View(this); }
+  bool Verify(::flatbuffers::Verifier &verifier) const {
     return VerifyTableStart(verifier) &&
            VerifyOffset(verifier, VT_LIST) &&
            verifier.VerifyVector(list()) &&
@@ -264,9 +344,9 @@ struct FooBarContainer FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
 
 struct FooBarContainerBuilder {
   typedef FooBarContainer Table;
-  flatbuffers::FlatBufferBuilder &fbb_;
-  flatbuffers::uoffset_t start_;
-  void add_list(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<benchmarks_flatbuffers::FooBar>>> list) {
+  ::flatbuffers::FlatBufferBuilder &fbb_;
+  ::flatbuffers::uoffset_t start_;
+  void add_list(::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<benchmarks_flatbuffers::FooBar>>> list) {
     fbb_.AddOffset(FooBarContainer::VT_LIST, list);
   }
   void add_initialized(bool initialized) {
@@ -275,26 +355,26 @@ struct FooBarContainerBuilder {
   void add_fruit(benchmarks_flatbuffers::Enum fruit) {
     fbb_.AddElement<int16_t>(FooBarContainer::VT_FRUIT, static_cast<int16_t>(fruit), 0);
   }
-  void add_location(flatbuffers::Offset<flatbuffers::String> location) {
+  void add_location(::flatbuffers::Offset<::flatbuffers::String> location) {
     fbb_.AddOffset(FooBarContainer::VT_LOCATION, location);
   }
-  explicit FooBarContainerBuilder(flatbuffers::FlatBufferBuilder &_fbb)
+  explicit FooBarContainerBuilder(::flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
     start_ = fbb_.StartTable();
   }
-  flatbuffers::Offset<FooBarContainer> Finish() {
+  ::flatbuffers::Offset<FooBarContainer> Finish() {
     const auto end = fbb_.EndTable(start_);
-    auto o = flatbuffers::Offset<FooBarContainer>(end);
+    auto o = ::flatbuffers::Offset<FooBarContainer>(end);
     return o;
   }
 };
 
-inline flatbuffers::Offset<FooBarContainer> CreateFooBarContainer(
-    flatbuffers::FlatBufferBuilder &_fbb,
-    flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<benchmarks_flatbuffers::FooBar>>> list = 0,
+inline ::flatbuffers::Offset<FooBarContainer> CreateFooBarContainer(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    ::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<benchmarks_flatbuffers::FooBar>>> list = 0,
     bool initialized = false,
     benchmarks_flatbuffers::Enum fruit = benchmarks_flatbuffers::Enum_Apples,
-    flatbuffers::Offset<flatbuffers::String> location = 0) {
+    ::flatbuffers::Offset<::flatbuffers::String> location = 0) {
   FooBarContainerBuilder builder_(_fbb);
   builder_.add_location(location);
   builder_.add_list(list);
@@ -303,13 +383,13 @@ inline flatbuffers::Offset<FooBarContainer> CreateFooBarContainer(
   return builder_.Finish();
 }
 
-inline flatbuffers::Offset<FooBarContainer> CreateFooBarContainerDirect(
-    flatbuffers::FlatBufferBuilder &_fbb,
-    const std::vector<flatbuffers::Offset<benchmarks_flatbuffers::FooBar>> *list = nullptr,
+inline ::flatbuffers::Offset<FooBarContainer> CreateFooBarContainerDirect(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    const std::vector<::flatbuffers::Offset<benchmarks_flatbuffers::FooBar>> *list = nullptr,
     bool initialized = false,
     benchmarks_flatbuffers::Enum fruit = benchmarks_flatbuffers::Enum_Apples,
     const char *location = nullptr) {
-  auto list__ = list ? _fbb.CreateVector<flatbuffers::Offset<benchmarks_flatbuffers::FooBar>>(*list) : 0;
+  auto list__ = list ? _fbb.CreateVector<::flatbuffers::Offset<benchmarks_flatbuffers::FooBar>>(*list) : 0;
   auto location__ = location ? _fbb.CreateString(location) : 0;
   return benchmarks_flatbuffers::CreateFooBarContainer(
       _fbb,
@@ -319,33 +399,295 @@ inline flatbuffers::Offset<FooBarContainer> CreateFooBarContainerDirect(
       location__);
 }
 
+struct IdEntry FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
+  typedef IdEntryBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_ID = 4,
+    VT_VALUE = 6
+  };
+  uint64_t id() const {
+    return GetField<uint64_t>(VT_ID, 0);
+  }
+  bool KeyCompareLessThan(const IdEntry * const o) const {
+    return id() < o->id();
+  }
+  int KeyCompareWithValue(uint64_t _id) const {
+    return static_cast<int>(id() > _id) - static_cast<int>(id() < _id);
+  }
+  uint32_t value() const {
+    return GetField<uint32_t>(VT_VALUE, 0);
+  }
+  // Reads fields without going through the vtable each time, see
+  // ::flatbuffers::TableView.
+  class View : private ::flatbuffers::TableView<2> {
+   public:
+    explicit View(const IdEntry *table)
+        : ::flatbuffers::TableView<2>(table) {}
+    uint64_t id() const {
+      return GetField<uint64_t>(VT_ID, 0);
+    }
+    uint32_t value() const {
+      return GetField<uint32_t>(VT_VALUE, 0);
+    }
+  };
+  View GetView() const { return View(this); }
+  bool Verify(::flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<uint64_t>(verifier, VT_ID, 8) &&
+           VerifyField<uint32_t>(verifier, VT_VALUE, 4) &&
+           verifier.EndTable();
+  }
+};
+
+struct IdEntryBuilder {
+  typedef IdEntry Table;
+  ::flatbuffers::FlatBufferBuilder &fbb_;
+  ::flatbuffers::uoffset_t start_;
+  void add_id(uint64_t id) {
+    fbb_.AddElement<uint64_t>(IdEntry::VT_ID, id, 0);
+  }
+  void add_value(uint32_t value) {
+    fbb_.AddElement<uint32_t>(IdEntry::VT_VALUE, value, 0);
+  }
+  explicit IdEntryBuilder(::flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  ::flatbuffers::Offset<IdEntry> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = ::flatbuffers::Offset<IdEntry>(end);
+    return o;
+  }
+};
+
+inline ::flatbuffers::Offset<IdEntry> CreateIdEntry(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    uint64_t id = 0,
+    uint32_t value = 0) {
+  IdEntryBuilder builder_(_fbb);
+  builder_.add_id(id);
+  builder_.add_value(value);
+  return builder_.Finish();
+}
+
+struct NameEntry FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
+  typedef NameEntryBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_NAME = 4,
+    VT_VALUE = 6
+  };
+  const ::flatbuffers::String *name() const {
+    return GetPointer<const ::flatbuffers::String *>(VT_NAME);
+  }
+  bool KeyCompareLessThan(const NameEntry * const o) const {
+    return *name() < *o->name();
+  }
+  int KeyCompareWithValue(const char *_name) const {
+    return strcmp(name()->c_str(), _name);
+  }
+  template<typename StringType>
+  int KeyCompareWithValue(const StringType& _name) const {
+    if (name()->c_str() < _name) return -1;
+    if (_name < name()->c_str()) return 1;
+    return 0;
+  }
+  const ::flatbuffers::String *KeyString() const {
+    return name();
+  }
+  uint32_t value() const {
+    return GetField<uint32_t>(VT_VALUE, 0);
+  }
+  // Reads fields without going through the vtable each time, see
+  // ::flatbuffers::TableView.
+  class View : private ::flatbuffers::TableView<2> {
+   public:
+    explicit View(const NameEntry *table)
+        : ::flatbuffers::TableView<2>(table) {}
+    const ::flatbuffers::String *name() const {
+      return GetPointer<const ::flatbuffers::String *>(VT_NAME);
+    }
+    uint32_t value() const {
+      return GetField<uint32_t>(VT_VALUE, 0);
+    }
+  };
+  View GetView() const { return View(this); }
+  bool Verify(::flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyOffsetRequired(verifier, VT_NAME) &&
+           verifier.VerifyString(name()) &&
+           VerifyField<uint32_t>(verifier, VT_VALUE, 4) &&
+           verifier.EndTable();
+  }
+};
+
+struct NameEntryBuilder {
+  typedef NameEntry Table;
+  ::flatbuffers::FlatBufferBuilder &fbb_;
+  ::flatbuffers::uoffset_t start_;
+  void add_name(::flatbuffers::Offset<::flatbuffers::String> name) {
+    fbb_.AddOffset(NameEntry::VT_NAME, name);
+  }
+  void add_value(uint32_t value) {
+    fbb_.AddElement<uint32_t>(NameEntry::VT_VALUE, value, 0);
+  }
+  explicit NameEntryBuilder(::flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  ::flatbuffers::Offset<NameEntry> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = ::flatbuffers::Offset<NameEntry>(end);
+    fbb_.Required(o, NameEntry::VT_NAME);
+    return o;
+  }
+};
+
+inline ::flatbuffers::Offset<NameEntry> CreateNameEntry(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    ::flatbuffers::Offset<::flatbuffers::String> name = 0,
+    uint32_t value = 0) {
+  NameEntryBuilder builder_(_fbb);
+  builder_.add_value(value);
+  builder_.add_name(name);
+  return builder_.Finish();
+}
+
+inline ::flatbuffers::Offset<NameEntry> CreateNameEntryDirect(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    const char *name = nullptr,
+    uint32_t value = 0) {
+  auto name__ = name ? _fbb.CreateString(name) : 0;
+  return benchmarks_flatbuffers::CreateNameEntry(
+      _fbb,
+      name__,
+      value);
+}
+
+struct Dictionary FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
+  typedef DictionaryBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_PAIRS = 4,
+    VT_BY_ID = 6,
+    VT_BY_NAME = 8
+  };
+  const ::flatbuffers::Vector<const benchmarks_flatbuffers::IdPair *> *pairs() const {
+    return GetPointer<const ::flatbuffers::Vector<const benchmarks_flatbuffers::IdPair *> *>(VT_PAIRS);
+  }
+  const ::flatbuffers::Vector<::flatbuffers::Offset<benchmarks_flatbuffers::IdEntry>> *by_id() const {
+    return GetPointer<const ::flatbuffers::Vector<::flatbuffers::Offset<benchmarks_flatbuffers::IdEntry>> *>(VT_BY_ID);
+  }
+  const ::flatbuffers::Vector<::flatbuffers::Offset<benchmarks_flatbuffers::NameEntry>> *by_name() const {
+    return GetPointer<const ::flatbuffers::Vector<::flatbuffers::Offset<benchmarks_flatbuffers::NameEntry>> *>(VT_BY_NAME);
+  }
+  // Reads fields without going through the vtable each time, see
+  // ::flatbuffers::TableView.
+  class View : private ::flatbuffers::TableView<3> {
+   public:
+    explicit View(const Dictionary *table)
+        : ::flatbuffers::TableView<3>(table) {}
+    const ::flatbuffers::Vector<const benchmarks_flatbuffers::IdPair *> *pairs() const {
+      return GetPointer<const ::flatbuffers::Vector<const benchmarks_flatbuffers::IdPair *> *>(VT_PAIRS);
+    }
+    const ::flatbuffers::Vector<::flatbuffers::Offset<benchmarks_flatbuffers::IdEntry>> *by_id() const {
+      return GetPointer<const ::flatbuffers::Vector<::flatbuffers::Offset<benchmarks_flatbuffers::IdEntry>> *>(VT_BY_ID);
+    }
+    const ::flatbuffers::Vector<::flatbuffers::Offset<benchmarks_flatbuffers::NameEntry>> *by_name() const {
+      return GetPointer<const ::flatbuffers::Vector<::flatbuffers::Offset<benchmarks_flatbuffers::NameEntry>> *>(VT_BY_NAME);
+    }
+  };
+  View GetView() const { return View(this); }
+  bool Verify(::flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyOffset(verifier, VT_PAIRS) &&
+           verifier.VerifyVector(pairs()) &&
+           VerifyOffset(verifier, VT_BY_ID) &&
+           verifier.VerifyVector(by_id()) &&
+           verifier.VerifyVectorOfTables(by_id()) &&
+           VerifyOffset(verifier, VT_BY_NAME) &&
+           verifier.VerifyVector(by_name()) &&
+           verifier.VerifyVectorOfTables(by_name()) &&
+           verifier.EndTable();
+  }
+};
+
+struct DictionaryBuilder {
+  typedef Dictionary Table;
+  ::flatbuffers::FlatBufferBuilder &fbb_;
+  ::flatbuffers::uoffset_t start_;
+  void add_pairs(::flatbuffers::Offset<::flatbuffers::Vector<const benchmarks_flatbuffers::IdPair *>> pairs) {
+    fbb_.AddOffset(Dictionary::VT_PAIRS, pairs);
+  }
+  void add_by_id(::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<benchmarks_flatbuffers::IdEntry>>> by_id) {
+    fbb_.AddOffset(Dictionary::VT_BY_ID, by_id);
+  }
+  void add_by_name(::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<benchmarks_flatbuffers::NameEntry>>> by_name) {
+    fbb_.AddOffset(Dictionary::VT_BY_NAME, by_name);
+  }
+  explicit DictionaryBuilder(::flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  ::flatbuffers::Offset<Dictionary> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = ::flatbuffers::Offset<Dictionary>(end);
+    return o;
+  }
+};
+
+inline ::flatbuffers::Offset<Dictionary> CreateDictionary(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    ::flatbuffers::Offset<::flatbuffers::Vector<const benchmarks_flatbuffers::IdPair *>> pairs = 0,
+    ::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<benchmarks_flatbuffers::IdEntry>>> by_id = 0,
+    ::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<benchmarks_flatbuffers::NameEntry>>> by_name = 0) {
+  DictionaryBuilder builder_(_fbb);
+  builder_.add_by_name(by_name);
+  builder_.add_by_id(by_id);
+  builder_.add_pairs(pairs);
+  return builder_.Finish();
+}
+
+inline ::flatbuffers::Offset<Dictionary> CreateDictionaryDirect(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    std::vector<benchmarks_flatbuffers::IdPair> *pairs = nullptr,
+    std::vector<::flatbuffers::Offset<benchmarks_flatbuffers::IdEntry>> *by_id = nullptr,
+    std::vector<::flatbuffers::Offset<benchmarks_flatbuffers::NameEntry>> *by_name = nullptr) {
+  auto pairs__ = pairs ? _fbb.CreateVectorOfSortedStructs<benchmarks_flatbuffers::IdPair>(pairs) : 0;
+  auto by_id__ = by_id ? _fbb.CreateVectorOfSortedTables<benchmarks_flatbuffers::IdEntry>(by_id) : 0;
+  auto by_name__ = by_name ? _fbb.CreateVectorOfSortedTables<benchmarks_flatbuffers::NameEntry>(by_name) : 0;
+  return benchmarks_flatbuffers::CreateDictionary(
+      _fbb,
+      pairs__,
+      by_id__,
+      by_name__);
+}
+
 inline const benchmarks_flatbuffers::FooBarContainer *GetFooBarContainer(const void *buf) {
-  return flatbuffers::GetRoot<benchmarks_flatbuffers::FooBarContainer>(buf);
+  return ::flatbuffers::GetRoot<benchmarks_flatbuffers::FooBarContainer>(buf);
 }
 
 inline const benchmarks_flatbuffers::FooBarContainer *GetSizePrefixedFooBarContainer(const void *buf) {
-  return flatbuffers::GetSizePrefixedRoot<benchmarks_flatbuffers::FooBarContainer>(buf);
+  return ::flatbuffers::GetSizePrefixedRoot<benchmarks_flatbuffers::FooBarContainer>(buf);
 }
 
 inline bool VerifyFooBarContainerBuffer(
-    flatbuffers::Verifier &verifier) {
+    ::flatbuffers::Verifier &verifier) {
   return verifier.VerifyBuffer<benchmarks_flatbuffers::FooBarContainer>(nullptr);
 }
 
 inline bool VerifySizePrefixedFooBarContainerBuffer(
-    flatbuffers::Verifier &verifier) {
+    ::flatbuffers::Verifier &verifier) {
   return verifier.VerifySizePrefixedBuffer<benchmarks_flatbuffers::FooBarContainer>(nullptr);
 }
 
 inline void FinishFooBarContainerBuffer(
-    flatbuffers::FlatBufferBuilder &fbb,
-    flatbuffers::Offset<benchmarks_flatbuffers::FooBarContainer> root) {
+    ::flatbuffers::FlatBufferBuilder &fbb,
+    ::flatbuffers::Offset<benchmarks_flatbuffers::FooBarContainer> root) {
   fbb.Finish(root);
 }
 
 inline void FinishSizePrefixedFooBarContainerBuffer(
-    flatbuffers::FlatBufferBuilder &fbb,
-    flatbuffers::Offset<benchmarks_flatbuffers::FooBarContainer> root) {
+    ::flatbuffers::FlatBufferBuilder &fbb,
+    ::flatbuffers::Offset<benchmarks_flatbuffers::FooBarContainer> root) {
   fbb.FinishSizePrefixed(root);
 }
 
@@ -0,0 +1,324 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "flatbuffers/arena_allocator.h"
+#include "flatbuffers/flatbuffer_builder_pool.h"
+#include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/util.h"
+
+using namespace flatbuffers;
+
+namespace {
+
+// Builds `kTablesPerBuffer` tables cycling through `num_shapes` distinct
+// layouts, where each bit of the shape index selects one field.
+void BuildDistinctVtables(FlatBufferBuilder &fbb, int64_t num_shapes) {
+  const int64_t kTablesPerBuffer = 20000;
+  for (int64_t i = 0; i < kTablesPerBuffer; i++) {
+    const int64_t shape = i % num_shapes + 1;
+    const uoffset_t start = fbb.StartTable();
+    for (voffset_t field = 0; field < 16; field++) {
+      if (shape & (int64_t(1) << field)) {
+        fbb.AddElement<uint8_t>(FieldIndexToOffset(field),
+                                static_cast<uint8_t>(i));
+      }
+    }
+    fbb.EndTable(start);
+  }
+}
+
+void DistinctVtables(benchmark::State &state, bool hash_vtables) {
+  FlatBufferBuilder fbb;
+  fbb.HashVtables(hash_vtables);
+  for (auto _ : state) {
+    fbb.Clear();
+    BuildDistinctVtables(fbb, state.range(0));
+    benchmark::DoNotOptimize(fbb.GetSize());
+  }
+}
+
+// Interns `kStringsPerBuffer` strings drawn from `num_unique` distinct tags.
+void SharedStrings(benchmark::State &state,
+                   FlatBufferBuilder::StringPool *pool) {
+  const int64_t kStringsPerBuffer = 10000;
+  std::vector<std::string> tags;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    tags.push_back("tag_" + NumToString(i));
+  }
+  FlatBufferBuilder fbb;
+  fbb.SetStringPool(pool);
+  for (auto _ : state) {
+    fbb.Clear();
+    for (int64_t i = 0; i < kStringsPerBuffer; i++) {
+      fbb.CreateSharedString(tags[static_cast<size_t>(i) % tags.size()]);
+    }
+    benchmark::DoNotOptimize(fbb.GetSize());
+  }
+  state.SetItemsProcessed(state.iterations() * kStringsPerBuffer);
+}
+
+// A request-sized message: a vector of tables with a string each.
+void BuildMessage(FlatBufferBuilder &fbb) {
+  const int kNumTables = 100;
+  Offset<Table> tables[kNumTables];
+  for (int i = 0; i < kNumTables; i++) {
+    const Offset<String> name = fbb.CreateString("request payload");
+    const uoffset_t start = fbb.StartTable();
+    fbb.AddOffset(FieldIndexToOffset(0), name);
+    fbb.AddElement<int64_t>(FieldIndexToOffset(1), i);
+    tables[i] = Offset<Table>(fbb.EndTable(start));
+  }
+  fbb.Finish(fbb.CreateVector(tables, kNumTables));
+}
+
+// Tracks the most memory held at once, as a stand-in for peak RSS.
+class PeakAllocator : public DefaultAllocator {
+ public:
+  PeakAllocator() : current_(0), peak_(0) {}
+
+  uint8_t *allocate(size_t size) override {
+    current_ += size;
+    peak_ = (std::max)(peak_, current_);
+    return DefaultAllocator::allocate(size);
+  }
+
+  void deallocate(uint8_t *p, size_t size) override {
+    current_ -= size;
+    DefaultAllocator::deallocate(p, size);
+  }
+
+  size_t peak() const { return peak_; }
+
+ private:
+  size_t current_;
+  size_t peak_;
+};
+
+// Builds a buffer of `state.range(0)` blobs of 1MB each.
+void LargePayload(benchmark::State &state, bool chunked) {
+  const size_t kBlobSize = 1 << 20;
+  const std::vector<uint8_t> blob(kBlobSize, 0xAB);
+  PeakAllocator allocator;
+  std::vector<Offset<Vector<uint8_t>>> blobs;
+  std::vector<span<const uint8_t>> chunks;
+  for (auto _ : state) {
+    FlatBufferBuilder fbb(1024, &allocator);
+    fbb.ChunkedBuffer(chunked);
+    blobs.clear();
+    for (int64_t i = 0; i < state.range(0); i++) {
+      blobs.push_back(fbb.CreateVector(blob));
+    }
+    fbb.Finish(fbb.CreateVector(blobs));
+    // What would be handed to writev().
+    fbb.GetBufferChunks(chunks);
+    benchmark::DoNotOptimize(chunks.data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          static_cast<int64_t>(kBlobSize));
+  state.counters["peak_bytes"] = static_cast<double>(allocator.peak());
+}
+
+// Builds tables `first` to `first + count` of a large vector of tables.
+void BuildTables(FlatBufferBuilder &fbb, int64_t first, int64_t count,
+                 Offset<Table> *tables) {
+  for (int64_t i = 0; i < count; i++) {
+    const Offset<String> name = fbb.CreateString("item " + NumToString(i));
+    const uoffset_t start = fbb.StartTable();
+    fbb.AddOffset(FieldIndexToOffset(0), name);
+    fbb.AddElement<int64_t>(FieldIndexToOffset(1), first + i);
+    tables[i] = Offset<Table>(fbb.EndTable(start));
+  }
+}
+
+const int64_t kNumTables = 100000;
+
+}  // namespace
+
+static void BM_Flatbuffers_VtableDedup_Linear(benchmark::State &state) {
+  DistinctVtables(state, false);
+}
+BENCHMARK(BM_Flatbuffers_VtableDedup_Linear)->Arg(10)->Arg(100)->Arg(10000);
+
+static void BM_Flatbuffers_VtableDedup_Hashed(benchmark::State &state) {
+  DistinctVtables(state, true);
+}
+BENCHMARK(BM_Flatbuffers_VtableDedup_Hashed)->Arg(10)->Arg(100)->Arg(10000);
+
+static void BM_Flatbuffers_CreateSharedString(benchmark::State &state) {
+  SharedStrings(state, nullptr);
+}
+BENCHMARK(BM_Flatbuffers_CreateSharedString)->Arg(10)->Arg(1000)->Arg(10000);
+
+static void BM_Flatbuffers_CreateSharedString_ExternalPool(
+    benchmark::State &state) {
+  FlatBufferBuilder::StringPool pool;
+  SharedStrings(state, &pool);
+}
+BENCHMARK(BM_Flatbuffers_CreateSharedString_ExternalPool)
+    ->Arg(10)
+    ->Arg(1000)
+    ->Arg(10000);
+
+static void BM_Flatbuffers_BuilderPerRequest(benchmark::State &state) {
+  for (auto _ : state) {
+    FlatBufferBuilder fbb;
+    BuildMessage(fbb);
+    benchmark::DoNotOptimize(fbb.GetBufferPointer());
+  }
+}
+BENCHMARK(BM_Flatbuffers_BuilderPerRequest);
+
+static void BM_Flatbuffers_BuilderPool(benchmark::State &state) {
+  FlatBufferBuilderPool pool;
+  for (auto _ : state) {
+    FlatBufferBuilderPool::Handle fbb = pool.Acquire();
+    BuildMessage(*fbb);
+    benchmark::DoNotOptimize(fbb->GetBufferPointer());
+  }
+}
+BENCHMARK(BM_Flatbuffers_BuilderPool);
+
+static void BM_Flatbuffers_BuilderArena(benchmark::State &state) {
+  ArenaAllocator arena;
+  for (auto _ : state) {
+    {
+      FlatBufferBuilder fbb(1024, &arena);
+      BuildMessage(fbb);
+      benchmark::DoNotOptimize(fbb.GetBufferPointer());
+    }
+    arena.reset();
+  }
+}
+BENCHMARK(BM_Flatbuffers_BuilderArena);
+
+static void BM_Flatbuffers_LargePayload_Contiguous(benchmark::State &state) {
+  LargePayload(state, false);
+}
+BENCHMARK(BM_Flatbuffers_LargePayload_Contiguous)->Arg(16)->Arg(128);
+
+static void BM_Flatbuffers_LargePayload_Chunked(benchmark::State &state) {
+  LargePayload(state, true);
+}
+BENCHMARK(BM_Flatbuffers_LargePayload_Chunked)->Arg(16)->Arg(128);
+
+// Like LargePayload, but streams each blob out as soon as it is built.
+static void BM_Flatbuffers_LargePayload_Streamed(benchmark::State &state) {
+  const size_t kBlobSize = 1 << 20;
+  const std::vector<uint8_t> blob(kBlobSize, 0xAB);
+  PeakAllocator allocator;
+  std::vector<Offset<Vector<uint8_t>>> blobs;
+  size_t written = 0;
+  auto sink = [&](const uint8_t *data, size_t len) {
+    benchmark::DoNotOptimize(data);
+    written += len;
+  };
+  for (auto _ : state) {
+    FlatBufferBuilder fbb(1024, &allocator);
+    fbb.ChunkedBuffer(true);
+    blobs.clear();
+    for (int64_t i = 0; i < state.range(0); i++) {
+      blobs.push_back(fbb.CreateVector(blob));
+      fbb.Flush(sink);
+    }
+    fbb.Finish(fbb.CreateVector(blobs));
+    fbb.Flush(sink);
+  }
+  benchmark::DoNotOptimize(written);
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          static_cast<int64_t>(kBlobSize));
+  state.counters["peak_bytes"] = static_cast<double>(allocator.peak());
+}
+BENCHMARK(BM_Flatbuffers_LargePayload_Streamed)->Arg(16)->Arg(128);
+
+static void BM_Flatbuffers_VectorOfTables_Serial(benchmark::State &state) {
+  std::vector<Offset<Table>> tables(kNumTables);
+  for (auto _ : state) {
+    FlatBufferBuilder fbb;
+    BuildTables(fbb, 0, kNumTables, tables.data());
+    fbb.Finish(fbb.CreateVector(tables));
+    benchmark::DoNotOptimize(fbb.GetBufferPointer());
+  }
+  state.SetItemsProcessed(state.iterations() * kNumTables);
+}
+BENCHMARK(BM_Flatbuffers_VectorOfTables_Serial)->UseRealTime();
+
+// Each of `state.range(0)` threads builds a slice of the tables in its own
+// builder, which are then appended to the final one.
+static void BM_Flatbuffers_VectorOfTables_Parallel(benchmark::State &state) {
+  const int64_t num_workers = state.range(0);
+  const int64_t per_worker = kNumTables / num_workers;
+  std::vector<Offset<Table>> tables(kNumTables);
+  for (auto _ : state) {
+    std::vector<FlatBufferBuilder> workers(static_cast<size_t>(num_workers));
+    std::vector<std::thread> threads;
+    for (int64_t w = 0; w < num_workers; w++) {
+      threads.emplace_back([&, w]() {
+        BuildTables(workers[static_cast<size_t>(w)], w * per_worker,
+                    per_worker, &tables[static_cast<size_t>(w * per_worker)]);
+      });
+    }
+    for (auto &thread : threads) thread.join();
+    FlatBufferBuilder fbb;
+    for (int64_t w = 0; w < num_workers; w++) {
+      fbb.AppendSubBuffer(workers[static_cast<size_t>(w)],
+                          &tables[static_cast<size_t>(w * per_worker)],
+                          static_cast<size_t>(per_worker));
+    }
+    fbb.Finish(fbb.CreateVector(tables.data(),
+                                static_cast<size_t>(num_workers * per_worker)));
+    benchmark::DoNotOptimize(fbb.GetBufferPointer());
+  }
+  state.SetItemsProcessed(state.iterations() * kNumTables);
+}
+BENCHMARK(BM_Flatbuffers_VectorOfTables_Parallel)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime();
+
+static void BM_Flatbuffers_CreateVectorScalarCast_Widen(
+    benchmark::State &state) {
+  const std::vector<int32_t> v(1 << 20, 12345);
+  FlatBufferBuilder fbb(v.size() * sizeof(int64_t) + 1024);
+  for (auto _ : state) {
+    fbb.Clear();
+    fbb.CreateVectorScalarCast<int64_t>(v.data(), v.size());
+    benchmark::DoNotOptimize(fbb.GetSize());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(v.size()));
+}
+BENCHMARK(BM_Flatbuffers_CreateVectorScalarCast_Widen);
+
+static void BM_Flatbuffers_CreateVectorScalarCast_Narrow(
+    benchmark::State &state) {
+  const std::vector<int64_t> v(1 << 20, 12345);
+  FlatBufferBuilder fbb(v.size() * sizeof(int16_t) + 1024);
+  for (auto _ : state) {
+    fbb.Clear();
+    fbb.CreateVectorScalarCast<int16_t>(v.data(), v.size());
+    benchmark::DoNotOptimize(fbb.GetSize());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(v.size()));
+}
+BENCHMARK(BM_Flatbuffers_CreateVectorScalarCast_Narrow);
+
+static void BM_Flatbuffers_CreateVectorOfBools(benchmark::State &state) {
+  std::vector<bool> v(1 << 20);
+  for (size_t i = 0; i < v.size(); i++) v[i] = i % 3 == 0;
+  FlatBufferBuilder fbb(v.size() + 1024);
+  for (auto _ : state) {
+    fbb.Clear();
+    fbb.CreateVector(v);
+    benchmark::DoNotOptimize(fbb.GetSize());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(v.size()));
+}
+BENCHMARK(BM_Flatbuffers_CreateVectorOfBools);
@@ -0,0 +1,204 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "benchmarks/cpp/flatbuffers/bench_generated.h"
+#include "flatbuffers/flatbuffers.h"
+
+using namespace flatbuffers;
+using namespace benchmarks_flatbuffers;
+
+namespace {
+
+// The number of lookups per iteration, of keys spread over the vector.
+const int kNumLookups = 1024;
+
+std::string EntryName(uint64_t i) {
+  char name[32];
+  snprintf(name, sizeof(name), "entry %010llu", (unsigned long long)i);
+  return name;
+}
+
+enum class Keys { kStructIds, kTableIds, kTableNames };
+
+// A Dictionary with `num_entries` entries, with ids 0, 2, 4, ... and names
+// to match, in the vector for `keys`.
+const std::vector<uint8_t> &BuildDictionary(int64_t num_entries, Keys keys) {
+  static std::vector<uint8_t> buf;
+  static int64_t built_entries = 0;
+  static Keys built_keys = Keys::kStructIds;
+  if (built_entries == num_entries && built_keys == keys) return buf;
+  buf.clear();
+  buf.shrink_to_fit();
+  FlatBufferBuilder fbb;
+  // Added in key order, so the vectors are sorted as they are.
+  Offset<Dictionary> dictionary;
+  switch (keys) {
+    case Keys::kStructIds: {
+      std::vector<IdPair> pairs;
+      for (int64_t i = 0; i < num_entries; i++) {
+        pairs.push_back(IdPair(static_cast<uint64_t>(2 * i),
+                               static_cast<uint64_t>(i)));
+      }
+      dictionary = CreateDictionary(fbb, fbb.CreateVectorOfStructs(pairs));
+      break;
+    }
+    case Keys::kTableIds: {
+      std::vector<Offset<IdEntry>> entries;
+      for (int64_t i = 0; i < num_entries; i++) {
+        entries.push_back(CreateIdEntry(fbb, static_cast<uint64_t>(2 * i),
+                                        static_cast<uint32_t>(i)));
+      }
+      dictionary = CreateDictionary(fbb, 0, fbb.CreateVector(entries));
+      break;
+    }
+    case Keys::kTableNames: {
+      std::vector<Offset<NameEntry>> entries;
+      for (int64_t i = 0; i < num_entries; i++) {
+        const auto name = fbb.CreateString(EntryName(2 * i));
+        entries.push_back(
+            CreateNameEntry(fbb, name, static_cast<uint32_t>(i)));
+      }
+      dictionary = CreateDictionary(fbb, 0, 0, fbb.CreateVector(entries));
+      break;
+    }
+  }
+  fbb.Finish(dictionary);
+  buf.assign(fbb.GetBufferPointer(), fbb.GetBufferPointer() + fbb.GetSize());
+  built_entries = num_entries;
+  built_keys = keys;
+  return buf;
+}
+
+// Ids to look up, of which half are in the dictionary.
+std::vector<uint64_t> RandomIds(int64_t num_entries) {
+  std::vector<uint64_t> ids;
+  uint64_t state = 1;
+  for (int i = 0; i < kNumLookups; i++) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    ids.push_back((state >> 16) % static_cast<uint64_t>(2 * num_entries));
+  }
+  return ids;
+}
+
+// LookupByKey as it was, through std::bsearch and a comparison function.
+template<typename T, typename K>
+typename Vector<T>::return_type BsearchByKey(const Vector<T> *vec,
+                                             const K &key) {
+  const void *found = std::bsearch(
+      &key, vec->Data(), vec->size(), IndirectHelper<T>::element_stride,
+      [](const void *ap, const void *bp) {
+        const auto elem = reinterpret_cast<const uint8_t *>(bp);
+        const auto table = IndirectHelper<T>::Read(elem, 0);
+        return -table->KeyCompareWithValue(*reinterpret_cast<const K *>(ap));
+      });
+  return found ? IndirectHelper<T>::Read(
+                     reinterpret_cast<const uint8_t *>(found), 0)
+               : nullptr;
+}
+
+template<typename T>
+void LookupIds(benchmark::State &state, const Vector<T> *entries,
+               bool bsearch) {
+  const std::vector<uint64_t> ids = RandomIds(state.range(0));
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (const uint64_t id : ids) {
+      const auto entry =
+          bsearch ? BsearchByKey(entries, id) : entries->LookupByKey(id);
+      if (entry) sum += entry->value();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kNumLookups);
+}
+
+void LookupStructIds(benchmark::State &state, bool bsearch) {
+  const std::vector<uint8_t> &buf =
+      BuildDictionary(state.range(0), Keys::kStructIds);
+  LookupIds(state, GetRoot<Dictionary>(buf.data())->pairs(), bsearch);
+}
+
+void LookupTableIds(benchmark::State &state, bool bsearch) {
+  const std::vector<uint8_t> &buf =
+      BuildDictionary(state.range(0), Keys::kTableIds);
+  LookupIds(state, GetRoot<Dictionary>(buf.data())->by_id(), bsearch);
+}
+
+void LookupTableNames(benchmark::State &state, bool bsearch) {
+  const std::vector<uint8_t> &buf =
+      BuildDictionary(state.range(0), Keys::kTableNames);
+  const auto entries = GetRoot<Dictionary>(buf.data())->by_name();
+  std::vector<std::string> names;
+  for (const uint64_t id : RandomIds(state.range(0))) {
+    names.push_back(EntryName(id));
+  }
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (const std::string &name : names) {
+      const char *key = name.c_str();
+      const NameEntry *entry =
+          bsearch ? BsearchByKey(entries, key) : entries->LookupByKey(key);
+      if (entry) sum += entry->value();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kNumLookups);
+}
+
+}  // namespace
+
+static void BM_Flatbuffers_LookupByKey_StructId(benchmark::State &state) {
+  LookupStructIds(state, false);
+}
+BENCHMARK(BM_Flatbuffers_LookupByKey_StructId)
+    ->Arg(1000)
+    ->Arg(100000)
+    ->Arg(10000000);
+
+static void BM_Flatbuffers_LookupByKey_StructId_Bsearch(
+    benchmark::State &state) {
+  LookupStructIds(state, true);
+}
+BENCHMARK(BM_Flatbuffers_LookupByKey_StructId_Bsearch)
+    ->Arg(1000)
+    ->Arg(100000)
+    ->Arg(10000000);
+
+static void BM_Flatbuffers_LookupByKey_TableId(benchmark::State &state) {
+  LookupTableIds(state, false);
+}
+BENCHMARK(BM_Flatbuffers_LookupByKey_TableId)
+    ->Arg(1000)
+    ->Arg(100000)
+    ->Arg(10000000);
+
+static void BM_Flatbuffers_LookupByKey_TableId_Bsearch(
+    benchmark::State &state) {
+  LookupTableIds(state, true);
+}
+BENCHMARK(BM_Flatbuffers_LookupByKey_TableId_Bsearch)
+    ->Arg(1000)
+    ->Arg(100000)
+    ->Arg(10000000);
+
+static void BM_Flatbuffers_LookupByKey_TableName(benchmark::State &state) {
+  LookupTableNames(state, false);
+}
+BENCHMARK(BM_Flatbuffers_LookupByKey_TableName)
+    ->Arg(1000)
+    ->Arg(100000)
+    ->Arg(10000000);
+
+static void BM_Flatbuffers_LookupByKey_TableName_Bsearch(
+    benchmark::State &state) {
+  LookupTableNames(state, true);
+}
+BENCHMARK(BM_Flatbuffers_LookupByKey_TableName_Bsearch)
+    ->Arg(1000)
+    ->Arg(100000)
+    ->Arg(10000000);
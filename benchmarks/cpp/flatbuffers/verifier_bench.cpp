@@ -0,0 +1,365 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "benchmarks/cpp/flatbuffers/bench_generated.h"
+#include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/idl.h"
+#include "flatbuffers/lazy_verifier.h"
+#include "flatbuffers/reflection.h"
+#include "flatbuffers/stream_verifier.h"
+#include "flatbuffers/verifier_thread_pool.h"
+
+using namespace flatbuffers;
+using namespace benchmarks_flatbuffers;
+
+namespace {
+
+const int kNumFields = 16;
+
+// A scalar-heavy table, verified either field by field, as generated code
+// does by default, or with VerifyInlineFields(), as generated with
+// --gen-fast-verifier.
+struct ScalarTable : private Table {
+  static voffset_t Field(int i) { return FieldIndexToOffset(i); }
+
+  bool VerifyPerField(Verifier &verifier) const {
+    bool ok = VerifyTableStart(verifier);
+    for (int i = 0; ok && i < kNumFields; i += 4) {
+      ok = VerifyField<int64_t>(verifier, Field(i), 8) &&
+           VerifyField<int32_t>(verifier, Field(i + 1), 4) &&
+           VerifyField<int16_t>(verifier, Field(i + 2), 2) &&
+           VerifyField<int8_t>(verifier, Field(i + 3), 1);
+    }
+    return ok && verifier.EndTable();
+  }
+
+  bool VerifyInline(Verifier &verifier) const {
+    static const voffset_t kInlineSizes[] = {
+      8, 4, 2, 1, 8, 4, 2, 1, 8, 4, 2, 1, 8, 4, 2, 1,
+    };
+    static const voffset_t kInlineAligns[] = {
+      8, 4, 2, 1, 8, 4, 2, 1, 8, 4, 2, 1, 8, 4, 2, 1,
+    };
+    return VerifyTableStart(verifier) &&
+           VerifyInlineFields(verifier, kInlineSizes, kInlineAligns) &&
+           verifier.EndTable();
+  }
+
+  bool Verify(Verifier &verifier) const { return VerifyInline(verifier); }
+};
+
+// A vector of `num_tables` tables with all fields set.
+std::vector<uint8_t> BuildScalarTables(int64_t num_tables) {
+  FlatBufferBuilder fbb;
+  std::vector<Offset<ScalarTable>> tables;
+  for (int64_t t = 0; t < num_tables; t++) {
+    const uoffset_t start = fbb.StartTable();
+    for (int i = 0; i < kNumFields; i += 4) {
+      fbb.AddElement<int64_t>(ScalarTable::Field(i), t + 1, 0);
+      fbb.AddElement<int32_t>(ScalarTable::Field(i + 1), 2, 0);
+      fbb.AddElement<int16_t>(ScalarTable::Field(i + 2), 3, 0);
+      fbb.AddElement<int8_t>(ScalarTable::Field(i + 3), 4, 0);
+    }
+    tables.push_back(Offset<ScalarTable>(fbb.EndTable(start)));
+  }
+  fbb.Finish(fbb.CreateVector(tables));
+  return std::vector<uint8_t>(fbb.GetBufferPointer(),
+                              fbb.GetBufferPointer() + fbb.GetSize());
+}
+
+void VerifyScalarTables(benchmark::State &state, bool inline_fields) {
+  const std::vector<uint8_t> buf = BuildScalarTables(state.range(0));
+  const auto tables = GetRoot<Vector<Offset<ScalarTable>>>(buf.data());
+  for (auto _ : state) {
+    Verifier::Options opts;
+    opts.max_tables = 10000000;
+    Verifier verifier(buf.data(), buf.size(), opts);
+    bool ok = verifier.VerifyVector(tables);
+    for (uoffset_t i = 0; ok && i < tables->size(); i++) {
+      ok = inline_fields ? tables->Get(i)->VerifyInline(verifier)
+                         : tables->Get(i)->VerifyPerField(verifier);
+    }
+    benchmark::DoNotOptimize(ok);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(buf.size()));
+}
+
+// Verifies the tables with VerifyVectorOfTables(), on `state.range(1)`
+// threads, or serially if 0.
+void VerifyScalarTablesParallel(benchmark::State &state) {
+  const std::vector<uint8_t> buf = BuildScalarTables(state.range(0));
+  const auto tables = GetRoot<Vector<Offset<ScalarTable>>>(buf.data());
+  VerifierThreadPool pool(static_cast<size_t>(state.range(1)));
+  for (auto _ : state) {
+    Verifier::Options opts;
+    opts.max_tables = 10000000;
+    Verifier verifier(buf.data(), buf.size(), opts);
+    if (state.range(1)) verifier.SetExecutor(&pool);
+    bool ok = verifier.VerifyVector(tables) &&
+              verifier.VerifyVectorOfTables(tables);
+    benchmark::DoNotOptimize(ok);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(buf.size()));
+}
+
+// A container of `num_foobars` FooBars.
+std::vector<uint8_t> BuildFooBars(int64_t num_foobars) {
+  FlatBufferBuilder fbb;
+  std::vector<Offset<FooBar>> foobars;
+  for (int64_t i = 0; i < num_foobars; i++) {
+    Foo foo(0xABADCAFEABADCAFE + i, 10000, '@', 1000000);
+    Bar bar(foo, 123456, 3.14159f, 10000);
+    const auto name = fbb.CreateString("Hello, World!");
+    foobars.push_back(CreateFooBar(fbb, &bar, name, 3.14, '!'));
+  }
+  const auto list = fbb.CreateVector(foobars);
+  const auto location = fbb.CreateString("http://google.com/flatbuffers/");
+  FinishFooBarContainerBuffer(
+      fbb, CreateFooBarContainer(fbb, list, true, Enum_Bananas, location));
+  return std::vector<uint8_t>(fbb.GetBufferPointer(),
+                              fbb.GetBufferPointer() + fbb.GetSize());
+}
+
+// Reads a single FooBar from a container, verifying the whole buffer first,
+// or only what is read with a LazyVerifier.
+void ReadOneFooBar(benchmark::State &state, bool lazy) {
+  const std::vector<uint8_t> buf = BuildFooBars(state.range(0));
+  const auto i = static_cast<uoffset_t>(state.range(0) / 2);
+  for (auto _ : state) {
+    const FooBar *foobar = nullptr;
+    if (lazy) {
+      LazyVerifier verifier(buf.data(), buf.size());
+      const auto container = verifier.GetRoot<FooBarContainer>();
+      if (container) foobar = verifier.Get(container->list(), i);
+    } else {
+      Verifier verifier(buf.data(), buf.size());
+      if (VerifyFooBarContainerBuffer(verifier)) {
+        foobar = GetFooBarContainer(buf.data())->list()->Get(i);
+      }
+    }
+    benchmark::DoNotOptimize(foobar ? foobar->rating() : 0.0);
+  }
+}
+
+// Verifies a whole container, counting into VerifierStats if `with_stats`.
+void VerifyFooBars(benchmark::State &state, bool with_stats) {
+  const std::vector<uint8_t> buf = BuildFooBars(state.range(0));
+  VerifierStats stats;
+  for (auto _ : state) {
+    Verifier verifier(buf.data(), buf.size());
+    if (with_stats) verifier.SetStats(&stats);
+    benchmark::DoNotOptimize(VerifyFooBarContainerBuffer(verifier));
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(buf.size()));
+}
+
+// `num_messages` size prefixed containers of a few FooBars, back to back.
+std::vector<uint8_t> BuildFooBarStream(int64_t num_messages) {
+  std::vector<uint8_t> stream;
+  FlatBufferBuilder fbb;
+  for (int64_t m = 0; m < num_messages; m++) {
+    fbb.Clear();
+    std::vector<Offset<FooBar>> foobars;
+    for (int i = 0; i < 3; i++) {
+      Foo foo(0xABADCAFEABADCAFE + i, 10000, '@', 1000000);
+      Bar bar(foo, 123456, 3.14159f, 10000);
+      const auto name = fbb.CreateString("Hello, World!");
+      foobars.push_back(CreateFooBar(fbb, &bar, name, 3.14, '!'));
+    }
+    const auto list = fbb.CreateVector(foobars);
+    FinishSizePrefixedFooBarContainerBuffer(
+        fbb, CreateFooBarContainer(fbb, list, true, Enum_Bananas));
+    stream.insert(stream.end(), fbb.GetBufferPointer(),
+                  fbb.GetBufferPointer() + fbb.GetSize());
+  }
+  return stream;
+}
+
+// Verifies a stream of messages with a Verifier each, or with a
+// SizePrefixedStreamVerifier on `threads` threads, if not 0.
+void VerifyFooBarStream(benchmark::State &state, bool batch) {
+  const std::vector<uint8_t> stream = BuildFooBarStream(state.range(0));
+  VerifierThreadPool pool(static_cast<size_t>(state.range(1)));
+  SizePrefixedStreamVerifier<FooBarContainer> stream_verifier;
+  if (state.range(1)) stream_verifier.SetExecutor(&pool);
+  for (auto _ : state) {
+    size_t valid = 0;
+    if (batch) {
+      stream_verifier.Verify(stream.data(), stream.size());
+      valid = stream_verifier.valid().size();
+    } else {
+      for (size_t offset = 0; offset < stream.size();) {
+        const size_t size = GetPrefixedSize(stream.data() + offset) +
+                            sizeof(uoffset_t);
+        Verifier verifier(stream.data() + offset, size);
+        valid += VerifySizePrefixedFooBarContainerBuffer(verifier);
+        offset += size;
+      }
+    }
+    benchmark::DoNotOptimize(valid);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(stream.size()));
+}
+
+// The schema of bench.fbs, as a binary schema.
+std::vector<uint8_t> BenchSchema() {
+  Parser parser;
+  const bool ok = parser.Parse(R"(
+    namespace benchmarks_flatbuffers;
+    enum Enum : short { Apples, Pears, Bananas }
+    struct Foo { id:ulong; count:short; prefix:byte; length:uint; }
+    struct Bar { parent:Foo; time:int; ratio:float; size:ushort; }
+    table FooBar { sibling:Bar; name:string; rating:double; postfix:ubyte; }
+    table FooBarContainer {
+      list:[FooBar]; initialized:bool; fruit:Enum; location:string;
+    }
+    root_type FooBarContainer;
+  )");
+  FLATBUFFERS_ASSERT(ok);
+  (void)ok;
+  parser.Serialize();
+  return std::vector<uint8_t>(
+      parser.builder_.GetBufferPointer(),
+      parser.builder_.GetBufferPointer() + parser.builder_.GetSize());
+}
+
+// Verifies a container with `check_alignment`, and with `buffer_alignment` if
+// `aligned`.
+void VerifyFooBarsAlignment(benchmark::State &state, bool check_alignment,
+                            bool aligned) {
+  const std::vector<uint8_t> foobars = BuildFooBars(state.range(0));
+  // Copied to storage that is known to be 8-byte aligned.
+  std::vector<uint64_t> buf((foobars.size() + 7) / 8);
+  memcpy(buf.data(), foobars.data(), foobars.size());
+  Verifier::Options opts;
+  opts.check_alignment = check_alignment;
+  if (aligned) opts.buffer_alignment = sizeof(uint64_t);
+  for (auto _ : state) {
+    Verifier verifier(reinterpret_cast<const uint8_t *>(buf.data()),
+                      foobars.size(), opts);
+    benchmark::DoNotOptimize(VerifyFooBarContainerBuffer(verifier));
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(foobars.size()));
+}
+
+enum class ReflectionMode { kGenerated, kReflection, kPlan };
+
+// Verifies a container with generated code, Verify() from reflection.h, or a
+// ReflectionVerifier.
+void VerifyFooBarsReflection(benchmark::State &state, ReflectionMode mode) {
+  const std::vector<uint8_t> buf = BuildFooBars(state.range(0));
+  const std::vector<uint8_t> bfbs = BenchSchema();
+  const reflection::Schema &schema = *reflection::GetSchema(bfbs.data());
+  const ReflectionVerifier plan(schema);
+  for (auto _ : state) {
+    bool ok = false;
+    switch (mode) {
+      case ReflectionMode::kGenerated: {
+        Verifier verifier(buf.data(), buf.size());
+        ok = VerifyFooBarContainerBuffer(verifier);
+        break;
+      }
+      case ReflectionMode::kReflection:
+        ok = flatbuffers::Verify(schema, *schema.root_table(), buf.data(),
+                                 buf.size());
+        break;
+      case ReflectionMode::kPlan: ok = plan.Verify(buf.data(), buf.size());
+    }
+    benchmark::DoNotOptimize(ok);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(buf.size()));
+}
+
+}  // namespace
+
+static void BM_Flatbuffers_Verify_PerField(benchmark::State &state) {
+  VerifyScalarTables(state, false);
+}
+BENCHMARK(BM_Flatbuffers_Verify_PerField)->Arg(1000)->Arg(100000);
+
+static void BM_Flatbuffers_Verify_InlineFields(benchmark::State &state) {
+  VerifyScalarTables(state, true);
+}
+BENCHMARK(BM_Flatbuffers_Verify_InlineFields)->Arg(1000)->Arg(100000);
+
+static void BM_Flatbuffers_Verify_VectorOfTables(benchmark::State &state) {
+  VerifyScalarTablesParallel(state);
+}
+BENCHMARK(BM_Flatbuffers_Verify_VectorOfTables)
+    ->Args({ 100000, 0 })
+    ->Args({ 100000, 2 })
+    ->Args({ 100000, 4 })
+    ->Args({ 100000, 8 })
+    ->UseRealTime();
+
+static void BM_Flatbuffers_Verify_ReadOne_Eager(benchmark::State &state) {
+  ReadOneFooBar(state, false);
+}
+BENCHMARK(BM_Flatbuffers_Verify_ReadOne_Eager)->Arg(1000)->Arg(100000);
+
+static void BM_Flatbuffers_Verify_ReadOne_Lazy(benchmark::State &state) {
+  ReadOneFooBar(state, true);
+}
+BENCHMARK(BM_Flatbuffers_Verify_ReadOne_Lazy)->Arg(1000)->Arg(100000);
+
+static void BM_Flatbuffers_Verify_NoStats(benchmark::State &state) {
+  VerifyFooBars(state, false);
+}
+BENCHMARK(BM_Flatbuffers_Verify_NoStats)->Arg(1000)->Arg(100000);
+
+static void BM_Flatbuffers_Verify_Stats(benchmark::State &state) {
+  VerifyFooBars(state, true);
+}
+BENCHMARK(BM_Flatbuffers_Verify_Stats)->Arg(1000)->Arg(100000);
+
+static void BM_Flatbuffers_Verify_Stream_PerMessage(benchmark::State &state) {
+  VerifyFooBarStream(state, false);
+}
+BENCHMARK(BM_Flatbuffers_Verify_Stream_PerMessage)->Args({ 10000, 0 });
+
+static void BM_Flatbuffers_Verify_Stream_Batch(benchmark::State &state) {
+  VerifyFooBarStream(state, true);
+}
+BENCHMARK(BM_Flatbuffers_Verify_Stream_Batch)
+    ->Args({ 10000, 0 })
+    ->Args({ 10000, 4 })
+    ->UseRealTime();
+
+static void BM_Flatbuffers_Verify_Generated(benchmark::State &state) {
+  VerifyFooBarsReflection(state, ReflectionMode::kGenerated);
+}
+BENCHMARK(BM_Flatbuffers_Verify_Generated)->Arg(1000);
+
+static void BM_Flatbuffers_Verify_Reflection(benchmark::State &state) {
+  VerifyFooBarsReflection(state, ReflectionMode::kReflection);
+}
+BENCHMARK(BM_Flatbuffers_Verify_Reflection)->Arg(1000);
+
+static void BM_Flatbuffers_Verify_ReflectionPlan(benchmark::State &state) {
+  VerifyFooBarsReflection(state, ReflectionMode::kPlan);
+}
+BENCHMARK(BM_Flatbuffers_Verify_ReflectionPlan)->Arg(1000);
+
+static void BM_Flatbuffers_Verify_CheckAlignment(benchmark::State &state) {
+  VerifyFooBarsAlignment(state, true, false);
+}
+BENCHMARK(BM_Flatbuffers_Verify_CheckAlignment)->Arg(1000)->Arg(100000);
+
+static void BM_Flatbuffers_Verify_NoCheckAlignment(benchmark::State &state) {
+  VerifyFooBarsAlignment(state, false, false);
+}
+BENCHMARK(BM_Flatbuffers_Verify_NoCheckAlignment)->Arg(1000)->Arg(100000);
+
+static void BM_Flatbuffers_Verify_BufferAlignment(benchmark::State &state) {
+  VerifyFooBarsAlignment(state, true, true);
+}
+BENCHMARK(BM_Flatbuffers_Verify_BufferAlignment)->Arg(1000)->Arg(100000);
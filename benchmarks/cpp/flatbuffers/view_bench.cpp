@@ -0,0 +1,101 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "benchmarks/cpp/flatbuffers/bench_generated.h"
+#include "flatbuffers/flatbuffers.h"
+
+using namespace flatbuffers;
+using namespace benchmarks_flatbuffers;
+
+namespace {
+
+// A container of `num_foobars` FooBars.
+std::vector<uint8_t> BuildFooBarList(int64_t num_foobars) {
+  FlatBufferBuilder fbb;
+  std::vector<Offset<FooBar>> foobars;
+  for (int64_t i = 0; i < num_foobars; i++) {
+    Foo foo(0xABADCAFEABADCAFE + i, 10000, '@', 1000000);
+    Bar bar(foo, 123456, 3.14159f, 10000);
+    const auto name = fbb.CreateString("Hello, World!");
+    foobars.push_back(CreateFooBar(fbb, &bar, name, 3.14, '!'));
+  }
+  FinishFooBarContainerBuffer(
+      fbb, CreateFooBarContainer(fbb, fbb.CreateVector(foobars)));
+  return std::vector<uint8_t>(fbb.GetBufferPointer(),
+                              fbb.GetBufferPointer() + fbb.GetSize());
+}
+
+// Sums all the fields of each FooBar, through its getters, or those of a
+// FooBar::View if `view`.
+template<typename T> int64_t SumFooBar(const T &foobar) {
+  return foobar.sibling()->time() +
+         static_cast<int64_t>(foobar.name()->size()) +
+         static_cast<int64_t>(foobar.rating()) + foobar.postfix();
+}
+
+// Copies all the fields of a FooBar to `out`, as when converting to another
+// format. Writing bytes may change any memory as far as the compiler knows,
+// so getters read the vtable again each time.
+template<typename T> uint8_t *WriteFooBar(const T &foobar, uint8_t *out) {
+  const Bar *sibling = foobar.sibling();
+  memcpy(out, sibling, sizeof(Bar));
+  out += sizeof(Bar);
+  const String *name = foobar.name();
+  memcpy(out, name->data(), name->size());
+  out += name->size();
+  const double rating = foobar.rating();
+  memcpy(out, &rating, sizeof(rating));
+  out += sizeof(rating);
+  *out++ = foobar.postfix();
+  return out;
+}
+
+void WriteFooBars(benchmark::State &state, bool view) {
+  const std::vector<uint8_t> buf = BuildFooBarList(state.range(0));
+  const auto list = GetFooBarContainer(buf.data())->list();
+  std::vector<uint8_t> out(buf.size());
+  for (auto _ : state) {
+    uint8_t *p = out.data();
+    for (const FooBar *foobar : *list) {
+      p = view ? WriteFooBar(foobar->GetView(), p) : WriteFooBar(*foobar, p);
+    }
+    benchmark::DoNotOptimize(p);
+  }
+}
+
+void SumFooBars(benchmark::State &state, bool view) {
+  const std::vector<uint8_t> buf = BuildFooBarList(state.range(0));
+  const auto list = GetFooBarContainer(buf.data())->list();
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (const FooBar *foobar : *list) {
+      sum += view ? SumFooBar(foobar->GetView()) : SumFooBar(*foobar);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+}
+
+}  // namespace
+
+static void BM_Flatbuffers_Read_Getters(benchmark::State &state) {
+  SumFooBars(state, false);
+}
+BENCHMARK(BM_Flatbuffers_Read_Getters)->Arg(1000)->Arg(100000);
+
+static void BM_Flatbuffers_Read_View(benchmark::State &state) {
+  SumFooBars(state, true);
+}
+BENCHMARK(BM_Flatbuffers_Read_View)->Arg(1000)->Arg(100000);
+
+static void BM_Flatbuffers_Write_Getters(benchmark::State &state) {
+  WriteFooBars(state, false);
+}
+BENCHMARK(BM_Flatbuffers_Write_Getters)->Arg(1000)->Arg(100000);
+
+static void BM_Flatbuffers_Write_View(benchmark::State &state) {
+  WriteFooBars(state, true);
+}
+BENCHMARK(BM_Flatbuffers_Write_View)->Arg(1000)->Arg(100000);
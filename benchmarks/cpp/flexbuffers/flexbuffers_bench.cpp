@@ -0,0 +1,386 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "flatbuffers/flexbuffers.h"
+#include "flatbuffers/idl.h"
+#include "flatbuffers/util.h"
+
+using namespace flatbuffers;
+
+namespace {
+
+// A vector of `num_records` maps, with shared keys and strings, and a blob of
+// `payload_size` bytes each.
+const std::vector<uint8_t> &Records(int64_t num_records, int64_t payload_size) {
+  static std::vector<uint8_t> buf;
+  static int64_t built_records = 0;
+  static int64_t built_payload_size = 0;
+  if (built_records != num_records || built_payload_size != payload_size) {
+    flexbuffers::Builder slb(1024 * 1024,
+                             flexbuffers::BUILDER_FLAG_SHARE_KEYS_AND_STRINGS);
+    const std::string description(200, 'x');
+    const std::vector<uint8_t> payload(static_cast<size_t>(payload_size),
+                                       0xAB);
+    slb.Vector([&]() {
+      for (int64_t i = 0; i < num_records; i++) {
+        slb.Map([&]() {
+          slb.String("name", NumToString(i) + description);
+          slb.Int("id", i);
+          slb.Vector("tags", [&]() {
+            slb.String("tag " + NumToString(i % 3));
+            slb.String("shared");
+          });
+          slb.Blob("payload", payload.data(), payload.size());
+        });
+      }
+    });
+    slb.Finish();
+    buf = slb.GetBuffer();
+    built_records = num_records;
+    built_payload_size = payload_size;
+  }
+  return buf;
+}
+
+enum class Tracker { kNone, kDense, kSparse };
+
+void VerifyRecords(benchmark::State &state, Tracker tracker) {
+  const std::vector<uint8_t> &buf = Records(state.range(0), state.range(1));
+  std::vector<uint8_t> reuse_tracker;
+  flexbuffers::SparseReuseTracker sparse_reuse_tracker;
+  for (auto _ : state) {
+    bool ok = false;
+    switch (tracker) {
+      case Tracker::kNone:
+        ok = flexbuffers::VerifyBuffer(buf.data(), buf.size());
+        break;
+      case Tracker::kDense:
+        ok = flexbuffers::VerifyBuffer(buf.data(), buf.size(), &reuse_tracker);
+        break;
+      case Tracker::kSparse:
+        ok = flexbuffers::VerifyBuffer(buf.data(), buf.size(),
+                                       sparse_reuse_tracker);
+    }
+    benchmark::DoNotOptimize(ok);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(buf.size()));
+}
+
+enum class KeyOrder { kSorted, kReverse, kRandom };
+
+// Builds maps of `num_keys` ints each, with about 100k keys in all, adding
+// the keys in `order`.
+void BuildMaps(benchmark::State &state, KeyOrder order) {
+  const size_t num_keys = static_cast<size_t>(state.range(0));
+  const size_t num_maps = std::max<size_t>(1, 100000 / num_keys);
+  std::vector<std::string> keys;
+  for (size_t i = 0; i < num_keys; i++) {
+    keys.push_back("field" + NumToString(i));
+  }
+  std::sort(keys.begin(), keys.end(),
+            [](const std::string &a, const std::string &b) {
+              return strcmp(a.c_str(), b.c_str()) < 0;
+            });
+  switch (order) {
+    case KeyOrder::kSorted: break;
+    case KeyOrder::kReverse: std::reverse(keys.begin(), keys.end()); break;
+    case KeyOrder::kRandom:
+      std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+      break;
+  }
+  flexbuffers::Builder slb(1024 * 1024);
+  for (auto _ : state) {
+    slb.Clear();
+    slb.Vector([&]() {
+      for (size_t i = 0; i < num_maps; i++) {
+        slb.Map([&]() {
+          for (size_t k = 0; k < num_keys; k++) {
+            slb.Int(keys[k].c_str(), static_cast<int64_t>(k));
+          }
+        });
+      }
+    });
+    slb.Finish();
+    benchmark::DoNotOptimize(slb.GetSize());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(num_maps * num_keys));
+}
+
+// Builds 20000 maps of 16 keys and 4 strings each, drawn from 5000 keys and
+// 5000 strings, with every key and string shared.
+void BuildKeyHeavy(benchmark::State &state) {
+  const size_t num_maps = 20000;
+  const size_t vocabulary = 5000;
+  std::vector<std::string> keys;
+  std::vector<std::string> strings;
+  for (size_t i = 0; i < vocabulary; i++) {
+    keys.push_back("attribute/" + NumToString(i * 7919 % vocabulary));
+    strings.push_back("value of a kind shared by many maps " + NumToString(i));
+  }
+  std::mt19937 rng(42);
+  std::vector<size_t> picks(num_maps * 20);
+  for (size_t &pick : picks) pick = rng() % vocabulary;
+  flexbuffers::Builder slb(1024 * 1024, flexbuffers::BUILDER_FLAG_SHARE_ALL);
+  for (auto _ : state) {
+    slb.Clear();
+    const size_t *pick = picks.data();
+    slb.Vector([&]() {
+      for (size_t i = 0; i < num_maps; i++) {
+        slb.Map([&]() {
+          for (int k = 0; k < 16; k++) {
+            slb.Int(keys[*pick++].c_str(), k);
+          }
+          for (int k = 0; k < 4; k++) {
+            slb.String(keys[k].c_str(), strings[*pick++]);
+          }
+        });
+      }
+    });
+    slb.Finish();
+    benchmark::DoNotOptimize(slb.GetSize());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(num_maps * 20));
+}
+
+// Telemetry records of 30 fields each, as JSON lines, in a JSON array.
+const std::string &TelemetryJson(int64_t num_records) {
+  static std::string json;
+  static int64_t built_records = 0;
+  if (built_records != num_records) {
+    json = "[\n";
+    for (int64_t i = 0; i < num_records; i++) {
+      json += i ? ",\n{" : "{";
+      json += "\"device\": \"sensor-" + NumToString(i % 100) + "\", ";
+      json += "\"seq\": " + NumToString(i) + ", ";
+      json += "\"ok\": " + std::string(i % 7 ? "true" : "false");
+      for (int f = 0; f < 27; f++) {
+        json += ", \"metric_" + NumToString(f) +
+                "\": " + NumToString((i * 31 + f * 7) % 1000);
+      }
+      json += "}";
+    }
+    json += "\n]";
+    built_records = num_records;
+  }
+  return json;
+}
+
+// Converts the telemetry records to a FlexBuffer with `flags`, reporting its
+// size in the "bytes" counter.
+void ParseTelemetry(benchmark::State &state, flexbuffers::BuilderFlag flags) {
+  const std::string &json = TelemetryJson(state.range(0));
+  flexbuffers::Builder slb(1024 * 1024, flags);
+  for (auto _ : state) {
+    slb.Clear();
+    Parser parser;
+    const bool ok = parser.ParseFlexBuffer(json.c_str(), nullptr, &slb);
+    benchmark::DoNotOptimize(ok);
+  }
+  state.counters["bytes"] = static_cast<double>(slb.GetSize());
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(json.size()));
+}
+
+// 100000 records of 30 fields each, sharing one keys vector.
+const std::vector<uint8_t> &SameShapeMaps() {
+  static std::vector<uint8_t> buf;
+  if (buf.empty()) {
+    flexbuffers::Builder slb(1024 * 1024, flexbuffers::BUILDER_FLAG_SHARE_ALL);
+    slb.Vector([&]() {
+      for (int64_t i = 0; i < 100000; i++) {
+        slb.Map([&]() {
+          for (int f = 0; f < 30; f++) {
+            slb.Int(("metric_" + NumToString(f)).c_str(), i + f);
+          }
+        });
+      }
+    });
+    slb.Finish();
+    buf = slb.GetBuffer();
+  }
+  return buf;
+}
+
+// Reads 4 fields of every record, by key, or through a MapKeyCache per key.
+void ReadFields(benchmark::State &state, bool cached) {
+  const auto records = flexbuffers::GetRoot(SameShapeMaps()).AsVector();
+  const char *keys[] = { "metric_3", "metric_12", "metric_21", "metric_29" };
+  for (auto _ : state) {
+    flexbuffers::MapKeyCache caches[] = { flexbuffers::MapKeyCache(keys[0]),
+                                          flexbuffers::MapKeyCache(keys[1]),
+                                          flexbuffers::MapKeyCache(keys[2]),
+                                          flexbuffers::MapKeyCache(keys[3]) };
+    int64_t sum = 0;
+    for (size_t i = 0; i < records.size(); i++) {
+      const auto record = records[i].AsMap();
+      for (int k = 0; k < 4; k++) {
+        sum += (cached ? caches[k].Get(record) : record[keys[k]]).AsInt64();
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(4 * records.size()));
+}
+
+// The telemetry records of TelemetryJson(), as a FlexBuffer.
+const std::vector<uint8_t> &TelemetryRecords() {
+  static std::vector<uint8_t> buf;
+  if (buf.empty()) {
+    flexbuffers::Builder slb(1024 * 1024, flexbuffers::BUILDER_FLAG_SHARE_ALL);
+    Parser parser;
+    parser.ParseFlexBuffer(TelemetryJson(20000).c_str(), nullptr, &slb);
+    buf = slb.GetBuffer();
+  }
+  return buf;
+}
+
+// Adds up the numbers of a FlexBuffer, and the sizes of its strings.
+struct SumVisitor : flexbuffers::Visitor {
+  SumVisitor() : sum(0) {}
+  void Bool(bool b) { sum += b; }
+  void Int(int64_t i) { sum += i; }
+  void UInt(uint64_t u) { sum += static_cast<int64_t>(u); }
+  void Float(double d) { sum += static_cast<int64_t>(d); }
+  void String(const char *, size_t len) { sum += static_cast<int64_t>(len); }
+  int64_t sum;
+};
+
+// The same as SumVisitor, through References.
+int64_t SumReferences(const flexbuffers::Reference &ref) {
+  int64_t sum = 0;
+  if (ref.IsMap()) {
+    const auto values = ref.AsMap().Values();
+    for (size_t i = 0; i < values.size(); i++) sum += SumReferences(values[i]);
+  } else if (ref.IsVector()) {
+    const auto vec = ref.AsVector();
+    for (size_t i = 0; i < vec.size(); i++) sum += SumReferences(vec[i]);
+  } else if (ref.IsTypedVector()) {
+    const auto vec = ref.AsTypedVector();
+    for (size_t i = 0; i < vec.size(); i++) sum += SumReferences(vec[i]);
+  } else if (ref.IsString()) {
+    sum += static_cast<int64_t>(ref.AsString().length());
+  } else if (ref.IsBool()) {
+    sum += ref.AsBool();
+  } else if (ref.IsIntOrUint()) {
+    sum += ref.AsInt64();
+  } else if (ref.IsFloat()) {
+    sum += static_cast<int64_t>(ref.AsDouble());
+  }
+  return sum;
+}
+
+}  // namespace
+
+// Buffers of about 13MB with many small objects, and 16MB with few large
+// ones.
+static void BM_Flexbuffers_Verify_NoTracker(benchmark::State &state) {
+  VerifyRecords(state, Tracker::kNone);
+}
+BENCHMARK(BM_Flexbuffers_Verify_NoTracker)
+    ->Args({ 1000, 64 })
+    ->Args({ 40000, 64 })
+    ->Args({ 4000, 4096 });
+
+static void BM_Flexbuffers_Verify_DenseTracker(benchmark::State &state) {
+  VerifyRecords(state, Tracker::kDense);
+}
+BENCHMARK(BM_Flexbuffers_Verify_DenseTracker)
+    ->Args({ 1000, 64 })
+    ->Args({ 40000, 64 })
+    ->Args({ 4000, 4096 });
+
+static void BM_Flexbuffers_Verify_SparseTracker(benchmark::State &state) {
+  VerifyRecords(state, Tracker::kSparse);
+}
+BENCHMARK(BM_Flexbuffers_Verify_SparseTracker)
+    ->Args({ 1000, 64 })
+    ->Args({ 40000, 64 })
+    ->Args({ 4000, 4096 });
+
+static void BM_Flexbuffers_BuildMap_Sorted(benchmark::State &state) {
+  BuildMaps(state, KeyOrder::kSorted);
+}
+BENCHMARK(BM_Flexbuffers_BuildMap_Sorted)->Arg(8)->Arg(64)->Arg(1024);
+
+static void BM_Flexbuffers_BuildMap_Reverse(benchmark::State &state) {
+  BuildMaps(state, KeyOrder::kReverse);
+}
+BENCHMARK(BM_Flexbuffers_BuildMap_Reverse)->Arg(8)->Arg(64)->Arg(1024);
+
+static void BM_Flexbuffers_BuildMap_Random(benchmark::State &state) {
+  BuildMaps(state, KeyOrder::kRandom);
+}
+BENCHMARK(BM_Flexbuffers_BuildMap_Random)->Arg(8)->Arg(64)->Arg(1024);
+
+static void BM_Flexbuffers_BuildKeyHeavy(benchmark::State &state) {
+  BuildKeyHeavy(state);
+}
+BENCHMARK(BM_Flexbuffers_BuildKeyHeavy);
+
+static void BM_Flexbuffers_ParseTelemetry_ShareKeys(benchmark::State &state) {
+  ParseTelemetry(state, flexbuffers::BUILDER_FLAG_SHARE_KEYS_AND_STRINGS);
+}
+BENCHMARK(BM_Flexbuffers_ParseTelemetry_ShareKeys)->Arg(1000)->Arg(100000);
+
+static void BM_Flexbuffers_ParseTelemetry_ShareKeyVectors(
+    benchmark::State &state) {
+  ParseTelemetry(state, flexbuffers::BUILDER_FLAG_SHARE_ALL);
+}
+BENCHMARK(BM_Flexbuffers_ParseTelemetry_ShareKeyVectors)
+    ->Arg(1000)
+    ->Arg(100000);
+
+static void BM_Flexbuffers_MapLookup(benchmark::State &state) {
+  ReadFields(state, false);
+}
+BENCHMARK(BM_Flexbuffers_MapLookup);
+
+static void BM_Flexbuffers_MapLookup_Cached(benchmark::State &state) {
+  ReadFields(state, true);
+}
+BENCHMARK(BM_Flexbuffers_MapLookup_Cached);
+
+static void BM_Flexbuffers_ToString(benchmark::State &state) {
+  const std::vector<uint8_t> &buf = TelemetryRecords();
+  const auto root = flexbuffers::GetRoot(buf);
+  for (auto _ : state) {
+    std::string json;
+    root.ToString(true, true, json);
+    benchmark::DoNotOptimize(json);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(buf.size()));
+}
+BENCHMARK(BM_Flexbuffers_ToString);
+
+static void BM_Flexbuffers_Walk(benchmark::State &state) {
+  const std::vector<uint8_t> &buf = TelemetryRecords();
+  for (auto _ : state) {
+    SumVisitor visitor;
+    flexbuffers::Walk(buf, visitor);
+    benchmark::DoNotOptimize(visitor.sum);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(buf.size()));
+}
+BENCHMARK(BM_Flexbuffers_Walk);
+
+static void BM_Flexbuffers_Walk_References(benchmark::State &state) {
+  const std::vector<uint8_t> &buf = TelemetryRecords();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(SumReferences(flexbuffers::GetRoot(buf)));
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(buf.size()));
+}
+BENCHMARK(BM_Flexbuffers_Walk_References);
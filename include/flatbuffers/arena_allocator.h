@@ -0,0 +1,238 @@
+/*
+ * Copyright 2024 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLATBUFFERS_ARENA_ALLOCATOR_H_
+#define FLATBUFFERS_ARENA_ALLOCATOR_H_
+
+#include "flatbuffers/allocator.h"
+#include "flatbuffers/base.h"
+#include "flatbuffers/default_allocator.h"
+
+namespace flatbuffers {
+
+// ArenaAllocator hands out memory by bumping a pointer through large chunks,
+// and frees everything at once in `reset()` or on destruction. Use it to
+// serve all builders (and their `DetachedBuffer`s) of a single request, and
+// drop all of their memory in one shot when the request is done.
+//
+// - `deallocate` only gives memory back if it was the most recent
+//   allocation, otherwise it is a no-op until `reset()`.
+// - `reallocate_downward` grows the most recent allocation in place when the
+//   current chunk has room, moving only the in-use back part, which is the
+//   common case for a single builder growing its buffer.
+// - Chunks come from an upstream allocator (the default allocator if null),
+//   and grow geometrically. Optionally, a caller owned buffer (e.g. on the
+//   stack) is used first, with chunks only used once that is exhausted.
+//
+// Not thread-safe. Memory handed out must not be used after `reset()`.
+class ArenaAllocator : public Allocator {
+ public:
+  explicit ArenaAllocator(size_t chunk_size = 64 * 1024,
+                          Allocator *upstream = nullptr)
+      : upstream_(upstream),
+        chunk_size_(chunk_size),
+        initial_(nullptr),
+        initial_size_(0),
+        first_(nullptr),
+        current_(nullptr),
+        cur_(nullptr),
+        end_(nullptr),
+        last_(nullptr),
+        bytes_used_(0) {}
+
+  ArenaAllocator(uint8_t *initial_buffer, size_t initial_size,
+                 size_t chunk_size = 64 * 1024, Allocator *upstream = nullptr)
+      : ArenaAllocator(chunk_size, upstream) {
+    initial_ = initial_buffer;
+    initial_size_ = initial_size;
+    Rewind();
+  }
+
+  ~ArenaAllocator() FLATBUFFERS_OVERRIDE { release(); }
+
+  uint8_t *allocate(size_t size) FLATBUFFERS_OVERRIDE {
+    uint8_t *p = AlignUp(cur_);
+    if (!cur_ || size > static_cast<size_t>(end_ - p)) {
+      NextChunk(size);
+      p = AlignUp(cur_);
+    }
+    cur_ = p + size;
+    last_ = p;
+    bytes_used_ += size;
+    return p;
+  }
+
+  void deallocate(uint8_t *p, size_t size) FLATBUFFERS_OVERRIDE {
+    // Only the most recent allocation can be given back before reset().
+    if (p == last_ && p + size == cur_) {
+      cur_ = p;
+      last_ = nullptr;
+      bytes_used_ -= size;
+    }
+  }
+
+  uint8_t *reallocate_downward(uint8_t *old_p, size_t old_size,
+                               size_t new_size, size_t in_use_back,
+                               size_t in_use_front) FLATBUFFERS_OVERRIDE {
+    FLATBUFFERS_ASSERT(new_size > old_size);  // vector_downward only grows
+    if (old_p == last_ && old_p + old_size == cur_ &&
+        new_size - old_size <= static_cast<size_t>(end_ - cur_)) {
+      // Grow in place: the front stays put, the back moves to the new end.
+      memmove(old_p + new_size - in_use_back, old_p + old_size - in_use_back,
+              in_use_back);
+      cur_ = old_p + new_size;
+      bytes_used_ += new_size - old_size;
+      return old_p;
+    }
+    return Allocator::reallocate_downward(old_p, old_size, new_size,
+                                          in_use_back, in_use_front);
+  }
+
+  // Makes all memory available again, invalidating everything allocated so
+  // far. Keeps the largest chunk, so an arena that is reset after each
+  // request stops allocating from upstream once it has warmed up. That need
+  // not be the last chunk, as one too small to reuse stays behind the new one.
+  void reset() {
+    if (first_) {
+      Chunk *keep = first_;
+      for (Chunk *c = first_->next; c; c = c->next) {
+        if (c->size > keep->size) keep = c;
+      }
+      FreeChunks(first_, keep);
+      FreeChunks(keep->next, nullptr);
+      keep->next = nullptr;
+      first_ = keep;
+    }
+    Rewind();
+  }
+
+  // Like reset(), but gives all chunks back to the upstream allocator.
+  void release() {
+    FreeChunks(first_, nullptr);
+    first_ = nullptr;
+    Rewind();
+  }
+
+  // Bytes handed out since construction or the last reset/release.
+  size_t bytes_used() const { return bytes_used_; }
+
+  // Number of chunks currently held from the upstream allocator.
+  size_t num_chunks() const {
+    size_t n = 0;
+    for (Chunk *c = first_; c; c = c->next) n++;
+    return n;
+  }
+
+ private:
+  // You shouldn't really be copying instances of this class.
+  FLATBUFFERS_DELETE_FUNC(ArenaAllocator(const ArenaAllocator &));
+  FLATBUFFERS_DELETE_FUNC(ArenaAllocator &operator=(const ArenaAllocator &));
+
+  // Alignment of every allocation, matching what `new uint8_t[]` provides.
+  static const size_t kAlignment = 16;
+
+  // Header placed at the start of each upstream chunk.
+  struct Chunk {
+    Chunk *next;
+    size_t size;  // Including this header.
+  };
+
+  static size_t HeaderSize() {
+    return (sizeof(Chunk) + kAlignment - 1) & ~(kAlignment - 1);
+  }
+
+  static uint8_t *AlignUp(uint8_t *p) {
+    const uintptr_t addr = reinterpret_cast<uintptr_t>(p);
+    return p + ((kAlignment - (addr & (kAlignment - 1))) & (kAlignment - 1));
+  }
+
+  static uint8_t *ChunkData(Chunk *chunk) {
+    return reinterpret_cast<uint8_t *>(chunk) + HeaderSize();
+  }
+
+  void Use(uint8_t *begin, size_t size) {
+    cur_ = begin;
+    end_ = begin + size;
+    last_ = nullptr;
+  }
+
+  // Start allocating from the beginning again.
+  void Rewind() {
+    current_ = nullptr;
+    if (initial_) {
+      Use(initial_, initial_size_);
+    } else if (first_) {
+      current_ = first_;
+      Use(ChunkData(first_), first_->size - HeaderSize());
+    } else {
+      cur_ = end_ = last_ = nullptr;
+    }
+    bytes_used_ = 0;
+  }
+
+  // Move on to a chunk that can hold `size` bytes, reusing chunks kept by
+  // reset() before getting a new one from upstream.
+  void NextChunk(size_t size) {
+    Chunk *next = current_ ? current_->next : first_;
+    if (next && next->size - HeaderSize() >= size + kAlignment - 1) {
+      current_ = next;
+      Use(ChunkData(next), next->size - HeaderSize());
+      return;
+    }
+    // Grow geometrically, so the number of chunks stays logarithmic.
+    size_t chunk_size = chunk_size_;
+    for (Chunk *c = first_; c; c = c->next) {
+      chunk_size = (std::max)(chunk_size, c->size * 2);
+    }
+    chunk_size = (std::max)(chunk_size, HeaderSize() + size + kAlignment);
+    auto chunk = reinterpret_cast<Chunk *>(Allocate(upstream_, chunk_size));
+    chunk->size = chunk_size;
+    // Chunks that are skipped because they are too small stay in the list, so
+    // they are freed along with the others.
+    chunk->next = next;
+    if (current_) {
+      current_->next = chunk;
+    } else {
+      first_ = chunk;
+    }
+    current_ = chunk;
+    Use(ChunkData(chunk), chunk_size - HeaderSize());
+  }
+
+  // Frees the chunks from `chunk` up to but excluding `stop`.
+  void FreeChunks(Chunk *chunk, Chunk *stop) {
+    while (chunk != stop) {
+      Chunk *next = chunk->next;
+      Deallocate(upstream_, reinterpret_cast<uint8_t *>(chunk), chunk->size);
+      chunk = next;
+    }
+  }
+
+  Allocator *upstream_;
+  size_t chunk_size_;
+  uint8_t *initial_;  // Caller owned buffer to use before any chunks.
+  size_t initial_size_;
+  Chunk *first_;    // Chunks from upstream, in the order they are used.
+  Chunk *current_;  // The chunk being allocated from, null if `initial_`.
+  uint8_t *cur_;   // Next free byte in the current chunk.
+  uint8_t *end_;   // End of the current chunk.
+  uint8_t *last_;  // Start of the most recent allocation.
+  size_t bytes_used_;
+};
+
+}  // namespace flatbuffers
+
+#endif  // FLATBUFFERS_ARENA_ALLOCATOR_H_
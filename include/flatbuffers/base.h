@@ -289,6 +289,14 @@ namespace flatbuffers {
   #define FLATBUFFERS_SUPPRESS_UBSAN(type)
 #endif
 
+// Hint that memory at `addr` is about to be read. Usage:
+// - FLATBUFFERS_PREFETCH(data + offset)
+#if defined(__GNUC__) || defined(__clang__)
+  #define FLATBUFFERS_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+  #define FLATBUFFERS_PREFETCH(addr)
+#endif
+
 namespace flatbuffers {
   // This is constexpr function used for checking compile-time constants.
   // Avoid `#pragma warning(disable: 4127) // C4127: expression is constant`.
@@ -447,6 +455,20 @@ template<typename T> FLATBUFFERS_SUPPRESS_UBSAN("alignment") void WriteScalar(vo
   *reinterpret_cast<uoffset_t *>(p) = EndianScalar(t.o);
 }
 
+// Writes `len` scalars converted to `T` to `p`, the bulk version of
+// WriteScalar. A plain loop over raw pointers, which compilers turn into SIMD
+// code for the conversion and any byte swapping, unlike pushing elements one
+// by one.
+template<typename T, typename U>
+// UBSAN: C++ aliasing type rules, see std::bit_cast<> for details.
+FLATBUFFERS_SUPPRESS_UBSAN("alignment")
+void WriteScalars(void *p, const U *src, size_t len) {
+  T *dst = reinterpret_cast<T *>(p);
+  for (size_t i = 0; i < len; i++) {
+    dst[i] = EndianScalar(static_cast<T>(src[i]));
+  }
+}
+
 #if (FLATBUFFERS_GCC >= 100000) && (FLATBUFFERS_GCC < 110000)
   #pragma GCC diagnostic pop
 #endif
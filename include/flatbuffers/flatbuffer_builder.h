@@ -30,6 +30,7 @@
 #include "flatbuffers/buffer_ref.h"
 #include "flatbuffers/default_allocator.h"
 #include "flatbuffers/detached_buffer.h"
+#include "flatbuffers/offset_hash_set.h"
 #include "flatbuffers/stl_emulation.h"
 #include "flatbuffers/string.h"
 #include "flatbuffers/struct.h"
@@ -107,7 +108,10 @@ template<bool Is64Aware = false> class FlatBufferBuilderImpl {
         minalign_(1),
         force_defaults_(false),
         dedup_vtables_(true),
-        string_pool(nullptr) {
+        hash_vtables_(false),
+        string_pool(nullptr),
+        own_string_pool_(false),
+        vtable_index_(nullptr) {
     EndianCheck();
   }
 
@@ -124,7 +128,10 @@ template<bool Is64Aware = false> class FlatBufferBuilderImpl {
         minalign_(1),
         force_defaults_(false),
         dedup_vtables_(true),
-        string_pool(nullptr) {
+        hash_vtables_(false),
+        string_pool(nullptr),
+        own_string_pool_(false),
+        vtable_index_(nullptr) {
     EndianCheck();
     // Default construct and swap idiom.
     // Lack of delegating constructors in vs2010 makes it more verbose than
@@ -151,11 +158,15 @@ template<bool Is64Aware = false> class FlatBufferBuilderImpl {
     swap(minalign_, other.minalign_);
     swap(force_defaults_, other.force_defaults_);
     swap(dedup_vtables_, other.dedup_vtables_);
+    swap(hash_vtables_, other.hash_vtables_);
     swap(string_pool, other.string_pool);
+    swap(own_string_pool_, other.own_string_pool_);
+    swap(vtable_index_, other.vtable_index_);
   }
 
   ~FlatBufferBuilderImpl() {
-    if (string_pool) delete string_pool;
+    if (own_string_pool_) delete string_pool;
+    if (vtable_index_) delete vtable_index_;
   }
 
   void Reset() {
@@ -173,8 +184,16 @@ template<bool Is64Aware = false> class FlatBufferBuilderImpl {
     minalign_ = 1;
     length_of_64_bit_region_ = 0;
     if (string_pool) string_pool->clear();
+    if (vtable_index_) vtable_index_->clear();
   }
 
+  /// @brief Make sure `size` more bytes can be added without growing the
+  /// buffer, growing it at most once. With an estimate of the final size, such
+  /// as `GetPackedSizeUpperBound()` generated by `--gen-packed-size`, this
+  /// builds a buffer with a single allocation.
+  /// @param[in] size The number of bytes to reserve.
+  void Reserve(size_t size) { buf_.ensure_space(size); }
+
   /// @brief The current size of the serialized buffer, counting from the end.
   /// @return Returns an `SizeT` with the current size of the buffer.
   SizeT GetSize() const { return buf_.size(); }
@@ -203,21 +222,67 @@ template<bool Is64Aware = false> class FlatBufferBuilderImpl {
   }
 
   /// @brief Get the serialized buffer (after you call `Finish()`).
+  /// With `ChunkedBuffer(true)`, call `Flatten()` first.
   /// @return Returns an `uint8_t` pointer to the FlatBuffer data inside the
   /// buffer.
   uint8_t *GetBufferPointer() const {
     Finished();
+    Contiguous();
     return buf_.data();
   }
 
   /// @brief Get the serialized buffer (after you call `Finish()`) as a span.
+  /// With `ChunkedBuffer(true)`, call `Flatten()` first.
   /// @return Returns a constructed flatbuffers::span that is a view over the
   /// FlatBuffer data inside the buffer.
   flatbuffers::span<uint8_t> GetBufferSpan() const {
     Finished();
+    Contiguous();
     return flatbuffers::span<uint8_t>(buf_.data(), buf_.size());
   }
 
+  /// @brief Get the serialized buffer (after you call `Finish()`) as a list
+  /// of memory chunks, which together in order form the FlatBuffer, e.g. to
+  /// pass to `writev()` without copying. Without `ChunkedBuffer(true)` this is
+  /// a single chunk.
+  /// @param[out] chunks Filled with the chunks, replacing any previous
+  /// contents.
+  void GetBufferChunks(std::vector<flatbuffers::span<const uint8_t>> &chunks)
+      const {
+    Finished();
+    chunks.clear();
+    for (size_t i = 0; i < buf_.num_chunks(); i++) {
+      size_t len = 0;
+      const uint8_t *data = buf_.chunk(i, len);
+      chunks.push_back(flatbuffers::span<const uint8_t>(data, len));
+    }
+  }
+
+  /// @brief Copy a chunked buffer into a single contiguous buffer, so that
+  /// `GetBufferPointer()` can be used. `Release()` does this implicitly.
+  void Flatten() { buf_.flatten(); }
+
+  /// @brief Stream the buffer out while building it, so that building a very
+  /// large buffer only takes memory for what is built between two calls.
+  /// Passes everything built so far to `sink(const uint8_t *data, size_t len)`
+  /// and frees it. The buffer comes out back to front: the first call gets
+  /// the end of the final buffer, and each later call gets the bytes right
+  /// before those of the call before. Call this once more after `Finish()` to
+  /// get the start of the buffer, for `GetSize()` bytes in total.
+  /// Offsets to flushed objects can be stored as usual, but the builder can't
+  /// read them anymore: vtables and shared strings written before are not
+  /// reused, and the finished buffer is only available through `sink`.
+  /// Requires `ChunkedBuffer(true)`, and no table or vector under
+  /// construction.
+  template<typename SinkT> void Flush(SinkT sink) {
+    NotNested();
+    // Forget about everything that points into the flushed data.
+    buf_.clear_scratch();
+    if (string_pool) string_pool->clear();
+    if (vtable_index_) vtable_index_->clear();
+    buf_.flush(sink);
+  }
+
   /// @brief Get a pointer to an unfinished buffer.
   /// @return Returns a `uint8_t` pointer to the unfinished buffer.
   uint8_t *GetCurrentBufferPointer() const { return buf_.data(); }
@@ -266,6 +331,13 @@ template<bool Is64Aware = false> class FlatBufferBuilderImpl {
     // GetCurrentBufferPointer instead.
     FLATBUFFERS_ASSERT(finished);
   }
+
+  void Contiguous() const {
+    // If you get this assert, the buffer is spread over several chunks. Call
+    // Flatten() to make it contiguous, or use GetBufferChunks() instead.
+    // After Flush(), the buffer is only available through its sink.
+    FLATBUFFERS_ASSERT(buf_.num_chunks() == 1 && !buf_.flushed());
+  }
   /// @endcond
 
   /// @brief In order to save space, fields that are set to their default value
@@ -279,6 +351,24 @@ template<bool Is64Aware = false> class FlatBufferBuilderImpl {
   /// @param[in] dedup When set to `true`, dedup vtables.
   void DedupVtables(bool dedup) { dedup_vtables_ = dedup; }
 
+  /// @brief By default vtables are deduped by scanning all previously written
+  /// vtables, which is fast for the few table shapes most schemas produce.
+  /// For buffers with thousands of distinct vtables (e.g. many different
+  /// union members), this becomes quadratic.
+  /// @param[in] hash When set to `true`, keep a hash index of the vtables
+  /// written so far (stored on the heap), so dedup costs O(1) per table.
+  void HashVtables(bool hash) { hash_vtables_ = hash; }
+
+  /// @brief By default the buffer is kept contiguous, and growing it copies
+  /// all data to a new buffer of 1.5 times the size. For very large buffers,
+  /// these copies dominate, and peak memory use is 2.5 times the data size.
+  /// @param[in] chunked When set to `true`, grow by adding a new chunk
+  /// instead, only copying the object under construction. Access the result
+  /// with `GetBufferChunks()`, or `Flatten()` it first to use
+  /// `GetBufferPointer()`. `GetTemporaryPointer()` does not work in this mode.
+  /// Setting it back to `false` flattens the buffer.
+  void ChunkedBuffer(bool chunked) { buf_.set_chunked(chunked); }
+
   /// @cond FLATBUFFERS_INTERNAL
   void Pad(size_t num_bytes) { buf_.fill(num_bytes); }
 
@@ -402,6 +492,8 @@ template<bool Is64Aware = false> class FlatBufferBuilderImpl {
     FLATBUFFERS_ASSERT(!nested);
     // If you hit this, fields were added outside the scope of a table.
     FLATBUFFERS_ASSERT(!num_field_loc);
+    // A new object starts here.
+    buf_.mark_object();
   }
 
   // From generated code (or from the parser), we call StartTable/EndTable
@@ -455,11 +547,25 @@ template<bool Is64Aware = false> class FlatBufferBuilderImpl {
     auto vt_use = GetSizeRelative32BitRegion();
     // See if we already have generated a vtable with this exact same
     // layout before. If so, make it point to the old one, remove this one.
-    if (dedup_vtables_) {
+    if (dedup_vtables_ && hash_vtables_) {
+      FLATBUFFERS_ASSERT(FLATBUFFERS_GENERAL_HEAP_ALLOC_OK);
+      if (!vtable_index_) vtable_index_ = new OffsetHashSet<uoffset_t>();
+      const uint32_t hash = HashFnv1aBytes(vt1, vt1_size);
+      const uoffset_t *existing =
+          vtable_index_->find(hash, VtableEqual(buf_, vt1, vt1_size,
+                                                length_of_64_bit_region_));
+      if (existing) {
+        vt_use = *existing;
+        buf_.pop(GetSizeRelative32BitRegion() - vtable_offset_loc);
+      } else {
+        vtable_index_->insert(hash, vt_use);
+      }
+    } else if (dedup_vtables_) {
       for (auto it = buf_.scratch_data(); it < buf_.scratch_end();
            it += sizeof(uoffset_t)) {
         auto vt_offset_ptr = reinterpret_cast<uoffset_t *>(it);
-        auto vt2 = reinterpret_cast<voffset_t *>(buf_.data_at(*vt_offset_ptr));
+        auto vt2 = reinterpret_cast<voffset_t *>(
+            buf_.chunked_data_at(*vt_offset_ptr));
         auto vt2_size = ReadScalar<voffset_t>(vt2);
         if (vt1_size != vt2_size || 0 != memcmp(vt2, vt1, vt1_size)) continue;
         vt_use = *vt_offset_ptr;
@@ -491,8 +597,15 @@ template<bool Is64Aware = false> class FlatBufferBuilderImpl {
   // This checks a required field has been set in a given table that has
   // just been constructed.
   template<typename T> void Required(Offset<T> table, voffset_t field) {
-    auto table_ptr = reinterpret_cast<const Table *>(buf_.data_at(table.o));
-    bool ok = table_ptr->GetOptionalFieldOffset(field) != 0;
+    // Find the vtable by offset rather than by pointer, as it may be in a
+    // different chunk than the table.
+    const auto vtable_offset =
+        static_cast<soffset_t>(table.o) +
+        ReadScalar<soffset_t>(buf_.chunked_data_at(table.o));
+    const auto vtable =
+        buf_.chunked_data_at(static_cast<size_t>(vtable_offset));
+    bool ok = field < ReadScalar<voffset_t>(vtable) &&
+              ReadScalar<voffset_t>(vtable + field) != 0;
     // If this fails, the caller will show what field needs to be set.
     FLATBUFFERS_ASSERT(ok);
     (void)ok;
@@ -594,35 +707,70 @@ template<bool Is64Aware = false> class FlatBufferBuilderImpl {
     return CreateString<OffsetT>(str.data(), str.length());
   }
 
+  /// @brief Specialized version of `CreateString` for non-copying use cases,
+  /// e.g. to `read()` the contents straight into their final place in the
+  /// buffer. The bytes are not initialized; the 0-terminator is added for you.
+  /// @param[in] len The number of bytes in the string, without terminator.
+  /// @param[out] buf Set to where the `len` bytes of the string go. Fill them
+  /// in before adding anything else, as that may move the buffer.
+  /// @return Returns the offset in the buffer where the string starts.
+  template<template<typename> class OffsetT = Offset>
+  OffsetT<String> CreateUninitializedString(size_t len, char **buf) {
+    NotNested();
+    PreAlign<uoffset_t>(len + 1);  // Always 0-terminated.
+    buf_.fill(1);
+    buf_.make_space(len);
+    const size_t str_start = GetSize();
+    PushElement(static_cast<uoffset_t>(len));
+    *buf = reinterpret_cast<char *>(buf_.data_at(str_start));
+    return OffsetT<String>(
+        CalculateOffset<typename OffsetT<String>::offset_type>());
+  }
+
   /// @brief Store a string in the buffer, which can contain any binary data.
   /// If a string with this exact contents has already been serialized before,
-  /// instead simply returns the offset of the existing string. This uses a map
-  /// stored on the heap, but only stores the numerical offsets.
+  /// instead simply returns the offset of the existing string. This uses a hash
+  /// set stored on the heap, but only stores the numerical offsets.
   /// @param[in] str A const char pointer to the data to be stored as a string.
   /// @param[in] len The number of bytes that should be stored from `str`.
   /// @return Returns the offset in the buffer where the string starts.
   Offset<String> CreateSharedString(const char *str, size_t len) {
     FLATBUFFERS_ASSERT(FLATBUFFERS_GENERAL_HEAP_ALLOC_OK);
     if (!string_pool) {
-      string_pool = new StringOffsetMap(StringOffsetCompare(buf_));
+      string_pool = new StringPool();
+      own_string_pool_ = true;
     }
 
-    const size_t size_before_string = buf_.size();
-    // Must first serialize the string, since the set is all offsets into
-    // buffer.
-    const Offset<String> off = CreateString<Offset>(str, len);
-    auto it = string_pool->find(off);
+    // Look the string up before serializing it, the set only holds offsets
+    // of strings already in the buffer.
+    const uint32_t hash = HashFnv1aBytes(str, len);
+    const uoffset_t *existing = string_pool->find(
+        hash, StringEqual(buf_, str, len, length_of_64_bit_region_));
     // If it exists we reuse existing serialized data!
-    if (it != string_pool->end()) {
-      // We can remove the string we serialized.
-      buf_.pop(buf_.size() - size_before_string);
-      return *it;
-    }
+    if (existing) return Offset<String>(*existing);
+    const Offset<String> off = CreateString<Offset>(str, len);
     // Record this string for future use.
-    string_pool->insert(off);
+    string_pool->insert(hash, off.o);
     return off;
   }
 
+  /// @brief The set of offsets `CreateSharedString` dedups against.
+  typedef OffsetHashSet<uoffset_t> StringPool;
+
+  /// @brief Use an external pool for `CreateSharedString`, instead of one
+  /// allocated by this builder on first use. The pool is cleared now and
+  /// whenever the builder is, but keeps its capacity. This allows a single
+  /// pool, whose slots may come from an arena `Allocator`, to be handed from
+  /// builder to builder. It must not be used by two builders at once.
+  /// @param[in] pool The pool to use, or null to go back to a pool owned by
+  /// this builder.
+  void SetStringPool(StringPool *pool) {
+    if (own_string_pool_) delete string_pool;
+    string_pool = pool;
+    own_string_pool_ = false;
+    if (string_pool) string_pool->clear();
+  }
+
 #ifdef FLATBUFFERS_HAS_STRING_VIEW
   /// @brief Store a string in the buffer, which can contain any binary data.
   /// If a string with this exact contents has already been serialized before,
@@ -751,9 +899,7 @@ template<bool Is64Aware = false> class FlatBufferBuilderImpl {
         if (sizeof(T) == 1) {
           PushBytes(reinterpret_cast<const uint8_t *>(v), len);
         } else {
-          for (auto i = len; i > 0; ) {
-            PushElement(v[--i]);
-          }
+          WriteScalars<T>(buf_.make_space(len * sizeof(T)), v, len);
         }
       #endif
       // clang-format on
@@ -810,11 +956,12 @@ template<bool Is64Aware = false> class FlatBufferBuilderImpl {
   // an array. Instead, read elements manually.
   // Background: https://isocpp.org/blog/2012/11/on-vectorbool
   Offset<Vector<uint8_t>> CreateVector(const std::vector<bool> &v) {
-    StartVector<uint8_t>(v.size());
-    for (auto i = v.size(); i > 0;) {
-      PushElement(static_cast<uint8_t>(v[--i]));
-    }
-    return Offset<Vector<uint8_t>>(EndVector(v.size()));
+    const size_t len = v.size();
+    StartVector<uint8_t>(len);
+    // Unpack the bits straight into the reserved space, rather than pushing
+    // them byte by byte.
+    std::copy(v.begin(), v.end(), buf_.make_space(len));
+    return Offset<Vector<uint8_t>>(EndVector(len));
   }
 
   /// @brief Serialize values returned by a function into a FlatBuffer `vector`.
@@ -1137,6 +1284,9 @@ template<bool Is64Aware = false> class FlatBufferBuilderImpl {
   template<typename T>
   Offset<Vector<Offset<T>>> CreateVectorOfSortedTables(Offset<T> *v,
                                                        size_t len) {
+    // Comparing keys follows pointers between tables, so needs a contiguous
+    // buffer.
+    buf_.flatten();
     std::stable_sort(v, v + len, TableKeyComparator<T>(buf_));
     return CreateVector(v, len);
   }
@@ -1193,6 +1343,15 @@ template<bool Is64Aware = false> class FlatBufferBuilderImpl {
                                      reinterpret_cast<uint8_t **>(buf));
   }
 
+  /// @brief Specialized version of `CreateVectorOfStructs` for non-copying
+  /// use cases, e.g. to decode an I/O buffer straight into the final place of
+  /// the structs. The memory is not initialized, so every struct has to be
+  /// written in full, padding included, before adding anything else.
+  /// @tparam T The struct type of the elements.
+  /// @param[in] len The number of structs to store in the `vector`.
+  /// @param[out] buf Set to where the structs go.
+  /// @return Returns a typed `Offset` into the serialized data indicating
+  /// where the vector is stored.
   template<typename T>
   Offset<Vector<const T *>> CreateUninitializedVectorOfStructs(size_t len,
                                                                T **buf) {
@@ -1208,10 +1367,69 @@ template<bool Is64Aware = false> class FlatBufferBuilderImpl {
     AssertScalarT<T>();
     AssertScalarT<U>();
     StartVector<T>(len);
-    for (auto i = len; i > 0;) { PushElement(static_cast<T>(v[--i])); }
+    WriteScalars<T>(buf_.make_space(len * sizeof(T)), v, len);
     return Offset<Vector<T>>(EndVector(len));
   }
 
+  /// @brief Copy everything built so far in another builder into this one,
+  /// to build independent parts of a large buffer in parallel: each thread
+  /// fills its own builder, and the results are appended here in turn.
+  /// The objects don't need any fixing up, as FlatBuffers offsets are
+  /// relative. Offsets into `sub` point to the copy after adding the returned
+  /// value, or use one of the overloads below to relocate them in place.
+  /// The vtables of `sub` are copied along with its tables, and are reused by
+  /// tables built here afterwards.
+  /// @param[in] sub A builder with no table under construction, that has not
+  /// been finished, and has nothing in its 64-bit region.
+  /// @return Returns the amount to add to offsets into `sub`.
+  uoffset_t AppendSubBuffer(const FlatBufferBuilderImpl &sub) {
+    NotNested();
+    // If you hit this, `sub` has a table under construction or is finished.
+    FLATBUFFERS_ASSERT(!sub.nested && !sub.finished);
+    FLATBUFFERS_ASSERT(!sub.length_of_64_bit_region_);
+    if (!sub.GetSize()) return 0;
+    // Keep everything in `sub` aligned as it was.
+    Align(sub.minalign_);
+    const uoffset_t base = GetSizeRelative32BitRegion();
+    // The last chunk holds the end of the data, so it goes first.
+    for (size_t i = sub.buf_.num_chunks(); i > 0; i--) {
+      size_t len = 0;
+      const uint8_t *data = sub.buf_.chunk(i - 1, len);
+      PushBytes(data, len);
+    }
+    if (dedup_vtables_) {
+      for (auto it = sub.buf_.scratch_data(); it < sub.buf_.scratch_end();
+           it += sizeof(uoffset_t)) {
+        ShareVtable(*reinterpret_cast<const uoffset_t *>(it) + base);
+      }
+    }
+    return base;
+  }
+
+  /// @brief Like `AppendSubBuffer(sub)`, relocating the given offsets into
+  /// `sub` so they point to the copy.
+  /// @param[in] sub The builder to copy from.
+  /// @param[in,out] offsets An array of offsets into `sub`.
+  /// @param[in] len The number of elements in `offsets`.
+  template<typename T>
+  void AppendSubBuffer(const FlatBufferBuilderImpl &sub, Offset<T> *offsets,
+                       size_t len) {
+    const uoffset_t base = AppendSubBuffer(sub);
+    for (size_t i = 0; i < len; i++) {
+      if (!offsets[i].IsNull()) offsets[i].o += base;
+    }
+  }
+
+  /// @brief Like `AppendSubBuffer(sub)`, relocating the given offsets into
+  /// `sub` so they point to the copy.
+  /// @param[in] sub The builder to copy from.
+  /// @param[in,out] offsets A `std::vector` of offsets into `sub`.
+  template<typename T, typename Alloc = std::allocator<T>>
+  void AppendSubBuffer(const FlatBufferBuilderImpl &sub,
+                       std::vector<Offset<T>, Alloc> &offsets) {
+    AppendSubBuffer(sub, data(offsets), offsets.size());
+  }
+
   /// @brief Write a struct by itself, typically to be part of a union.
   template<typename T> Offset<const T *> CreateStruct(const T &structobj) {
     NotNested();
@@ -1328,21 +1546,85 @@ template<bool Is64Aware = false> class FlatBufferBuilderImpl {
 
   bool dedup_vtables_;
 
-  struct StringOffsetCompare {
-    explicit StringOffsetCompare(const vector_downward<SizeT> &buf)
-        : buf_(&buf) {}
-    bool operator()(const Offset<String> &a, const Offset<String> &b) const {
-      auto stra = reinterpret_cast<const String *>(buf_->data_at(a.o));
-      auto strb = reinterpret_cast<const String *>(buf_->data_at(b.o));
-      return StringLessThan(stra->data(), stra->size(), strb->data(),
-                            strb->size());
+  bool hash_vtables_;  // Dedup vtables through `vtable_index_`.
+
+  // Compares a string not yet serialized against one in the buffer, given its
+  // offset relative to the end of the 32-bit region.
+  struct StringEqual {
+    StringEqual(const vector_downward<SizeT> &buf, const char *str, size_t len,
+                size_t length_of_64_bit_region)
+        : buf_(&buf),
+          str_(str),
+          len_(len),
+          length_of_64_bit_region_(length_of_64_bit_region) {}
+    bool operator()(const uoffset_t off) const {
+      auto existing = reinterpret_cast<const String *>(
+          buf_->chunked_data_at(off + length_of_64_bit_region_));
+      return existing->size() == len_ &&
+             0 == memcmp(existing->data(), str_, len_);
+    }
+    const vector_downward<SizeT> *buf_;
+    const char *str_;
+    size_t len_;
+    size_t length_of_64_bit_region_;
+  };
+
+  // For use with CreateSharedString. Instantiated on first use only, unless
+  // set with SetStringPool.
+  StringPool *string_pool;
+  bool own_string_pool_;
+
+  // Compares the vtable just written at the head of the buffer against one
+  // written before, given its offset relative to the end of the 32-bit region.
+  struct VtableEqual {
+    VtableEqual(const vector_downward<SizeT> &buf, const voffset_t *vt,
+                voffset_t vt_size, size_t length_of_64_bit_region)
+        : buf_(&buf),
+          vt_(vt),
+          vt_size_(vt_size),
+          length_of_64_bit_region_(length_of_64_bit_region) {}
+    bool operator()(const uoffset_t off) const {
+      auto existing = buf_->chunked_data_at(off + length_of_64_bit_region_);
+      return ReadScalar<voffset_t>(existing) == vt_size_ &&
+             0 == memcmp(existing, vt_, vt_size_);
     }
     const vector_downward<SizeT> *buf_;
+    const voffset_t *vt_;
+    voffset_t vt_size_;
+    size_t length_of_64_bit_region_;
   };
 
-  // For use with CreateSharedString. Instantiated on first use only.
-  typedef std::set<Offset<String>, StringOffsetCompare> StringOffsetMap;
-  StringOffsetMap *string_pool;
+  // For use with HashVtables. Instantiated on first use only.
+  OffsetHashSet<uoffset_t> *vtable_index_;
+
+  // Makes the vtable at `vt_offset` available to tables built from here on,
+  // unless there is an identical one already.
+  void ShareVtable(uoffset_t vt_offset) {
+    auto vt = reinterpret_cast<const voffset_t *>(
+        buf_.chunked_data_at(vt_offset + length_of_64_bit_region_));
+    auto vt_size = ReadScalar<voffset_t>(vt);
+    if (hash_vtables_) {
+      FLATBUFFERS_ASSERT(FLATBUFFERS_GENERAL_HEAP_ALLOC_OK);
+      if (!vtable_index_) vtable_index_ = new OffsetHashSet<uoffset_t>();
+      const uint32_t hash = HashFnv1aBytes(vt, vt_size);
+      if (vtable_index_->find(hash, VtableEqual(buf_, vt, vt_size,
+                                                length_of_64_bit_region_))) {
+        return;
+      }
+      vtable_index_->insert(hash, vt_offset);
+    } else {
+      for (auto it = buf_.scratch_data(); it < buf_.scratch_end();
+           it += sizeof(uoffset_t)) {
+        auto vt2 =
+            buf_.chunked_data_at(*reinterpret_cast<const uoffset_t *>(it));
+        if (ReadScalar<voffset_t>(vt2) == vt_size &&
+            0 == memcmp(vt2, vt, vt_size)) {
+          return;
+        }
+      }
+    }
+    buf_.scratch_push_small(vt_offset);
+  }
 
  private:
   void CanAddOffset64() {
@@ -1463,6 +1745,7 @@ inline void FlatBufferBuilder64::StartVector<Offset64, uint64_t>(
 /// Helpers to get a typed pointer to objects that are currently being built.
 /// @warning Creating new objects will lead to reallocations and invalidates
 /// the pointer!
+/// @warning Requires a contiguous buffer, see `ChunkedBuffer()`.
 template<typename T>
 T *GetMutableTemporaryPointer(FlatBufferBuilder &fbb, Offset<T> offset) {
   return reinterpret_cast<T *>(fbb.GetCurrentBufferPointer() + fbb.GetSize() -
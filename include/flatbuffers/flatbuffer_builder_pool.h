@@ -0,0 +1,310 @@
+/*
+ * Copyright 2024 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLATBUFFERS_FLATBUFFER_BUILDER_POOL_H_
+#define FLATBUFFERS_FLATBUFFER_BUILDER_POOL_H_
+
+#include <atomic>
+#include <memory>
+
+#include "flatbuffers/base.h"
+#include "flatbuffers/flatbuffer_builder.h"
+
+namespace flatbuffers {
+
+/// @addtogroup flatbuffers_cpp_api
+/// @{
+/// @class FlatBufferBuilderPool
+/// @brief A thread-safe pool of `FlatBufferBuilder`s that keep their buffers
+/// between uses, so that steady-state serialization does not allocate.
+/// `Acquire()` returns a handle that gives the builder back to the pool when
+/// it goes out of scope, after clearing it. Each thread keeps a few builders
+/// in a local cache that is accessed without synchronization; the rest live
+/// on a lock-free stack shared by all threads.
+/// Builders that have not been used yet are created with an initial size
+/// equal to the largest buffer built so far (the high-water mark), so they
+/// grow at most once.
+/// If more builders are in use than the pool holds, extra ones are allocated
+/// on the fly and destroyed when returned.
+/// All handles must be returned before the pool is destroyed.
+template<bool Is64Aware = false> class FlatBufferBuilderPoolImpl {
+ public:
+  typedef FlatBufferBuilderImpl<Is64Aware> BuilderT;
+
+ private:
+  struct Node {
+    Node() : next(0), warm(false) {}
+    BuilderT builder;
+    // Index + 1 of the next node on the shared stack, or 0 for none.
+    std::atomic<uint32_t> next;
+    // Whether `builder` has been used, and thus holds a buffer.
+    bool warm;
+  };
+
+  struct State;
+
+ public:
+  /// @brief A move-only handle to a pooled builder, returning it to the pool
+  /// when destroyed.
+  class Handle {
+   public:
+    Handle() : state_(nullptr), node_(nullptr), index_(kOverflow) {}
+
+    Handle(Handle &&other) noexcept
+        : state_(other.state_), node_(other.node_), index_(other.index_) {
+      other.node_ = nullptr;
+    }
+
+    Handle &operator=(Handle &&other) noexcept {
+      // Move construct a temporary and swap idiom
+      Handle temp(std::move(other));
+      swap(temp);
+      return *this;
+    }
+
+    ~Handle() { Reset(); }
+
+    void swap(Handle &other) {
+      using std::swap;
+      swap(state_, other.state_);
+      swap(node_, other.node_);
+      swap(index_, other.index_);
+    }
+
+    BuilderT &operator*() const { return node_->builder; }
+    BuilderT *operator->() const { return &node_->builder; }
+    BuilderT *get() const { return node_ ? &node_->builder : nullptr; }
+
+    /// @brief Releases the finished buffer like `FlatBufferBuilder::Release`,
+    /// recording its size for the pool's high-water mark first. The buffer
+    /// leaves with the `DetachedBuffer`, so prefer reading it in place when
+    /// the builder is to be reused without allocating.
+    DetachedBuffer Release() {
+      state_->RecordSize(node_->builder.GetSize());
+      return node_->builder.Release();
+    }
+
+    /// @brief Gives the builder back to the pool early.
+    void Reset() {
+      if (node_) state_->Return(node_, index_);
+      node_ = nullptr;
+    }
+
+   private:
+    friend class FlatBufferBuilderPoolImpl;
+
+    Handle(State *state, Node *node, uint32_t index)
+        : state_(state), node_(node), index_(index) {}
+
+    // You shouldn't really be copying instances of this class.
+    FLATBUFFERS_DELETE_FUNC(Handle(const Handle &));
+    FLATBUFFERS_DELETE_FUNC(Handle &operator=(const Handle &));
+
+    State *state_;
+    Node *node_;
+    uint32_t index_;
+  };
+
+  /// @brief Constructor for FlatBufferBuilderPool.
+  /// @param[in] max_pooled The number of builders kept by the pool.
+  /// @param[in] initial_size The minimum initial size of the builders.
+  /// @param[in] allocator An `Allocator` for all builders to use. If null will
+  /// use `DefaultAllocator`. Not owned by the pool.
+  explicit FlatBufferBuilderPoolImpl(size_t max_pooled = 64,
+                                     size_t initial_size = 1024,
+                                     Allocator *allocator = nullptr)
+      : state_(std::make_shared<State>(max_pooled, initial_size, allocator)) {
+    state_->self = state_;
+  }
+
+  ~FlatBufferBuilderPoolImpl() {
+    // If you hit this, a Handle outlived the pool it came from.
+    FLATBUFFERS_ASSERT(state_->outstanding.load() == 0);
+  }
+
+  /// @brief Get a cleared builder from the pool, with a warm buffer if one is
+  /// available.
+  Handle Acquire() {
+    State *state = state_.get();
+    ThreadCache &cache = LocalCache();
+    uint32_t index = kOverflow;
+    if (cache.id == state->id && cache.count) {
+      index = cache.nodes[--cache.count];
+    } else {
+      index = state->Pop();
+    }
+    state->outstanding++;
+    if (index == kOverflow) {
+      Node *node = new Node();
+      node->builder = BuilderT(state->InitialSize(), state->allocator);
+      return Handle(state, node, kOverflow);
+    }
+    Node *node = &state->nodes[index];
+    if (!node->warm) {
+      node->builder = BuilderT(state->InitialSize(), state->allocator);
+      node->warm = true;
+    }
+    return Handle(state, node, index);
+  }
+
+  /// @brief The size of the largest buffer built with this pool so far.
+  size_t HighWaterMark() const { return state_->high_water.load(); }
+
+ private:
+  // You shouldn't really be copying instances of this class.
+  FLATBUFFERS_DELETE_FUNC(
+      FlatBufferBuilderPoolImpl(const FlatBufferBuilderPoolImpl &));
+  FLATBUFFERS_DELETE_FUNC(
+      FlatBufferBuilderPoolImpl &operator=(const FlatBufferBuilderPoolImpl &));
+
+  static const uint32_t kOverflow = 0xFFFFFFFF;
+  static const uint32_t kThreadCacheSize = 4;
+
+  // Everything shared by the pool, its handles and the thread caches. Thread
+  // caches only hold a weak reference, so they can tell whether the pool
+  // they cache builders for is still alive.
+  struct State {
+    State(size_t max_pooled, size_t initial, Allocator *alloc)
+        : id(NextId()),
+          nodes(new Node[max_pooled]),
+          num_nodes(max_pooled),
+          head(0),
+          high_water(0),
+          outstanding(0),
+          initial_size(initial),
+          allocator(alloc) {
+      FLATBUFFERS_ASSERT(max_pooled < kOverflow);
+      for (size_t i = 0; i < num_nodes; i++) Push(static_cast<uint32_t>(i));
+    }
+
+    static uint64_t NextId() {
+      static std::atomic<uint64_t> next_id(1);
+      return next_id++;
+    }
+
+    // The shared stack is a Treiber stack. `head` holds the index + 1 of the
+    // top node in its low 32 bits and a counter in the high 32 bits, bumped on
+    // every update so a node popped and pushed back (ABA) fails the CAS.
+    void Push(uint32_t index) {
+      uint64_t old_head = head.load(std::memory_order_relaxed);
+      uint64_t new_head;
+      do {
+        nodes[index].next.store(static_cast<uint32_t>(old_head),
+                                std::memory_order_relaxed);
+        new_head = ((old_head >> 32) + 1) << 32 | (index + 1);
+      } while (!head.compare_exchange_weak(old_head, new_head,
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed));
+    }
+
+    uint32_t Pop() {
+      uint64_t old_head = head.load(std::memory_order_acquire);
+      uint64_t new_head;
+      do {
+        const uint32_t top = static_cast<uint32_t>(old_head);
+        if (!top) return kOverflow;
+        const uint32_t next =
+            nodes[top - 1].next.load(std::memory_order_relaxed);
+        new_head = ((old_head >> 32) + 1) << 32 | next;
+      } while (!head.compare_exchange_weak(old_head, new_head,
+                                           std::memory_order_acquire,
+                                           std::memory_order_acquire));
+      return static_cast<uint32_t>(old_head) - 1;
+    }
+
+    void RecordSize(size_t size) {
+      size_t current = high_water.load(std::memory_order_relaxed);
+      while (size > current &&
+             !high_water.compare_exchange_weak(current, size,
+                                               std::memory_order_relaxed)) {
+      }
+    }
+
+    size_t InitialSize() const {
+      return (std::max)(initial_size,
+                        high_water.load(std::memory_order_relaxed));
+    }
+
+    void Return(Node *node, uint32_t index) {
+      RecordSize(node->builder.GetSize());
+      outstanding--;
+      if (index == kOverflow) {
+        delete node;
+        return;
+      }
+      node->builder.Clear();
+      ThreadCache &cache = LocalCache();
+      if (cache.id != id) cache.Bind(this);
+      if (cache.count < kThreadCacheSize) {
+        cache.nodes[cache.count++] = index;
+      } else {
+        Push(index);
+      }
+    }
+
+    const uint64_t id;
+    std::unique_ptr<Node[]> nodes;
+    const size_t num_nodes;
+    std::atomic<uint64_t> head;
+    std::atomic<size_t> high_water;
+    std::atomic<size_t> outstanding;
+    const size_t initial_size;
+    Allocator *const allocator;
+    std::weak_ptr<State> self;
+  };
+
+  // Builders cached by the current thread, for one pool at a time.
+  struct ThreadCache {
+    ThreadCache() : id(0), count(0) {}
+
+    ~ThreadCache() { Flush(); }
+
+    // Hands the cached builders back to the shared stack of their pool, if it
+    // still exists, and starts caching for `state` instead.
+    void Bind(State *state) {
+      Flush();
+      owner = state->self;
+      id = state->id;
+    }
+
+    void Flush() {
+      if (std::shared_ptr<State> state = owner.lock()) {
+        while (count) state->Push(nodes[--count]);
+      }
+      count = 0;
+    }
+
+    uint64_t id;
+    std::weak_ptr<State> owner;
+    uint32_t count;
+    uint32_t nodes[kThreadCacheSize];
+  };
+
+  static ThreadCache &LocalCache() {
+    static thread_local ThreadCache cache;
+    return cache;
+  }
+
+  std::shared_ptr<State> state_;
+};
+/// @}
+
+using FlatBufferBuilderPool = FlatBufferBuilderPoolImpl<false>;
+using FlatBufferBuilderPool64 = FlatBufferBuilderPoolImpl<true>;
+
+}  // namespace flatbuffers
+
+#endif  // FLATBUFFERS_FLATBUFFER_BUILDER_POOL_H_
@@ -27,6 +27,10 @@ inline bool VerifyNestedFlexBuffer(
     const flatbuffers::Vector<uint8_t> *const nested,
     flatbuffers::Verifier &verifier) {
   if (!nested) return true;
+  if (auto sparse_reuse_tracker = verifier.GetFlexSparseReuseTracker()) {
+    return verifier.Check(flexbuffers::VerifyBuffer(
+        nested->data(), nested->size(), *sparse_reuse_tracker));
+  }
   return verifier.Check(flexbuffers::VerifyBuffer(
       nested->data(), nested->size(), verifier.GetFlexReuseTracker()));
 }
@@ -21,6 +21,7 @@
 #include <map>
 // Used to select STL variant.
 #include "flatbuffers/base.h"
+#include "flatbuffers/offset_hash_set.h"
 // We use the basic binary writing functions from the regular FlatBuffers.
 #include "flatbuffers/util.h"
 
@@ -37,6 +38,7 @@ namespace flexbuffers {
 
 class Reference;
 class Map;
+class MapKeyCache;
 
 // These are used in the lower 2 bits of a type field to determine the size of
 // the elements (and or size field) of the item pointed to (e.g. vector).
@@ -339,6 +341,10 @@ class Map : public Vector {
   Reference operator[](const char *key) const;
   Reference operator[](const std::string &key) const;
 
+  // The index of `key` in Keys() and Values(), or Keys().size() if it is not
+  // there.
+  size_t KeyIndex(const char *key) const;
+
   Vector Values() const { return Vector(data_, byte_width_); }
 
   TypedVector Keys() const {
@@ -358,6 +364,42 @@ class Map : public Vector {
   }
 
   bool IsTheEmptyMap() const { return data_ == EmptyMap().data_; }
+
+ private:
+  // Where the keys vector starts, which maps may share.
+  const uint8_t *KeysData() const {
+    return Indirect(data_ - byte_width_ * 3, byte_width_);
+  }
+
+  friend MapKeyCache;
+};
+
+// Looks up one key in many maps, such as the records of a table, finding its
+// index again only when a map has another keys vector than the last one:
+//
+//   flexbuffers::MapKeyCache name("name");
+//   for (size_t i = 0; i < records.size(); i++) {
+//     auto record_name = name.Get(records[i].AsMap()).AsString();
+//   }
+//
+// Maps only share a keys vector if built with BUILDER_FLAG_SHARE_KEY_VECTORS,
+// otherwise this is a plain lookup. Keys vectors are told apart by address,
+// so call Reset() before using a MapKeyCache with another buffer.
+class MapKeyCache {
+ public:
+  explicit MapKeyCache(const char *key)
+      : key_(key), keys_(nullptr), index_(0) {}
+  explicit MapKeyCache(const std::string &key)
+      : key_(key), keys_(nullptr), index_(0) {}
+
+  Reference Get(const Map &map);
+
+  void Reset() { keys_ = nullptr; }
+
+ private:
+  std::string key_;
+  const uint8_t *keys_;  // The keys vector `index_` was found in.
+  size_t index_;
 };
 
 inline void IndentString(std::string &s, int indent,
@@ -365,36 +407,6 @@ inline void IndentString(std::string &s, int indent,
   for (int i = 0; i < indent; i++) s += indent_string;
 }
 
-template<typename T>
-void AppendToString(std::string &s, T &&v, bool keys_quoted, bool indented,
-                    int cur_indent, const char *indent_string,
-                    bool natural_utf8) {
-  s += "[";
-  s += indented ? "\n" : " ";
-  for (size_t i = 0; i < v.size(); i++) {
-    if (i) {
-      s += ",";
-      s += indented ? "\n" : " ";
-    }
-    if (indented) IndentString(s, cur_indent, indent_string);
-    v[i].ToString(true, keys_quoted, s, indented, cur_indent,
-                  indent_string, natural_utf8);
-  }
-  if (indented) {
-    s += "\n";
-    IndentString(s, cur_indent - 1, indent_string);
-  } else {
-    s += " ";
-  }
-  s += "]";
-}
-
-template<typename T>
-void AppendToString(std::string &s, T &&v, bool keys_quoted) {
-  AppendToString(s, v, keys_quoted);
-}
-
-
 class Reference {
  public:
   Reference()
@@ -574,87 +586,7 @@ class Reference {
   // This version additionally allow you to specify if you want indentation.
   void ToString(bool strings_quoted, bool keys_quoted, std::string &s,
                 bool indented, int cur_indent, const char *indent_string,
-                bool natural_utf8 = false) const {
-    if (type_ == FBT_STRING) {
-      String str(Indirect(), byte_width_);
-      if (strings_quoted) {
-        flatbuffers::EscapeString(str.c_str(), str.length(), &s, true, natural_utf8);
-      } else {
-        s.append(str.c_str(), str.length());
-      }
-    } else if (IsKey()) {
-      auto str = AsKey();
-      if (keys_quoted) {
-        flatbuffers::EscapeString(str, strlen(str), &s, true, natural_utf8);
-      } else {
-        s += str;
-      }
-    } else if (IsInt()) {
-      s += flatbuffers::NumToString(AsInt64());
-    } else if (IsUInt()) {
-      s += flatbuffers::NumToString(AsUInt64());
-    } else if (IsFloat()) {
-      s += flatbuffers::NumToString(AsDouble());
-    } else if (IsNull()) {
-      s += "null";
-    } else if (IsBool()) {
-      s += AsBool() ? "true" : "false";
-    } else if (IsMap()) {
-      s += "{";
-      s += indented ? "\n" : " ";
-      auto m = AsMap();
-      auto keys = m.Keys();
-      auto vals = m.Values();
-      for (size_t i = 0; i < keys.size(); i++) {
-        bool kq = keys_quoted;
-        if (!kq) {
-          // FlexBuffers keys may contain arbitrary characters, only allow
-          // unquoted if it looks like an "identifier":
-          const char *p = keys[i].AsKey();
-          if (!flatbuffers::is_alpha(*p) && *p != '_') {
-            kq = true;
-          } else {
-            while (*++p) {
-              if (!flatbuffers::is_alnum(*p) && *p != '_') {
-                kq = true;
-                break;
-              }
-            }
-          }
-        }
-        if (indented) IndentString(s, cur_indent + 1, indent_string);
-        keys[i].ToString(true, kq, s);
-        s += ": ";
-        vals[i].ToString(true, keys_quoted, s, indented, cur_indent + 1, indent_string,
-                         natural_utf8);
-        if (i < keys.size() - 1) {
-          s += ",";
-          if (!indented) s += " ";
-        }
-        if (indented) s += "\n";
-      }
-      if (!indented) s += " ";
-      if (indented) IndentString(s, cur_indent, indent_string);
-      s += "}";
-    } else if (IsVector()) {
-      AppendToString<Vector>(s, AsVector(), keys_quoted, indented,
-                             cur_indent + 1, indent_string, natural_utf8);
-    } else if (IsTypedVector()) {
-      AppendToString<TypedVector>(s, AsTypedVector(), keys_quoted, indented,
-                                  cur_indent + 1, indent_string,
-                                  natural_utf8);
-    } else if (IsFixedTypedVector()) {
-      AppendToString<FixedTypedVector>(s, AsFixedTypedVector(), keys_quoted,
-                                       indented, cur_indent + 1, indent_string,
-                                       natural_utf8);
-    } else if (IsBlob()) {
-      auto blob = AsBlob();
-      flatbuffers::EscapeString(reinterpret_cast<const char *>(blob.data()),
-                                blob.size(), &s, true, false);
-    } else {
-      s += "(?)";
-    }
-  }
+                bool natural_utf8 = false) const;
 
   // This function returns the empty blob if you try to read a not-blob.
   // Strings can be viewed as blobs too.
@@ -820,6 +752,7 @@ class Reference {
   }
 
   friend class Verifier;
+  template<typename V> friend void Walk(const Reference &root, V &visitor);
 
   const uint8_t *data_;
   uint8_t parent_width_;
@@ -898,6 +831,8 @@ inline Reference FixedTypedVector::operator[](size_t i) const {
   return Reference(elem, byte_width_, 1, type_);
 }
 
+// Compares `key` with the key at `elem`, an offset of type T, in the way of
+// std::bsearch() comparison functions.
 template<typename T> int KeyCompare(const void *key, const void *elem) {
   auto str_elem = reinterpret_cast<const char *>(
       Indirect<T>(reinterpret_cast<const uint8_t *>(elem)));
@@ -905,28 +840,54 @@ template<typename T> int KeyCompare(const void *key, const void *elem) {
   return strcmp(skey, str_elem);
 }
 
-inline Reference Map::operator[](const char *key) const {
+// The index of `key` in the `len` sorted keys at `keys`, with offsets of type
+// T, or `len` if it is not there.
+template<typename T>
+size_t FindKey(const uint8_t *keys, size_t len, const char *key) {
+  size_t lo = 0;
+  size_t hi = len;
+  while (lo < hi) {
+    const size_t mid = lo + (hi - lo) / 2;
+    const int comp = KeyCompare<T>(key, keys + mid * sizeof(T));
+    if (comp == 0) return mid;
+    if (comp < 0) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  return len;
+}
+
+inline size_t Map::KeyIndex(const char *key) const {
   auto keys = Keys();
-  // We can't pass keys.byte_width_ to the comparison function, so we have
-  // to pick the right one ahead of time.
-  int (*comp)(const void *, const void *) = nullptr;
   switch (keys.byte_width_) {
-    case 1: comp = KeyCompare<uint8_t>; break;
-    case 2: comp = KeyCompare<uint16_t>; break;
-    case 4: comp = KeyCompare<uint32_t>; break;
-    case 8: comp = KeyCompare<uint64_t>; break;
-    default: FLATBUFFERS_ASSERT(false); return Reference();
-  }
-  auto res = std::bsearch(key, keys.data_, keys.size(), keys.byte_width_, comp);
-  if (!res) return Reference(nullptr, 1, NullPackedType());
-  auto i = (reinterpret_cast<uint8_t *>(res) - keys.data_) / keys.byte_width_;
-  return (*static_cast<const Vector *>(this))[i];
+    case 1: return FindKey<uint8_t>(keys.data_, keys.size(), key);
+    case 2: return FindKey<uint16_t>(keys.data_, keys.size(), key);
+    case 4: return FindKey<uint32_t>(keys.data_, keys.size(), key);
+    case 8: return FindKey<uint64_t>(keys.data_, keys.size(), key);
+    default: FLATBUFFERS_ASSERT(false); return keys.size();
+  }
+}
+
+inline Reference Map::operator[](const char *key) const {
+  // Out of range if not found, which gives a null Reference.
+  return (*static_cast<const Vector *>(this))[KeyIndex(key)];
 }
 
 inline Reference Map::operator[](const std::string &key) const {
   return (*this)[key.c_str()];
 }
 
+inline Reference MapKeyCache::Get(const Map &map) {
+  const uint8_t *keys = map.KeysData();
+  if (keys != keys_) {
+    index_ = map.KeyIndex(key_.c_str());
+    keys_ = keys;
+  }
+  return map.Values()[index_];
+}
+
 inline Reference GetRoot(const uint8_t *buffer, size_t size) {
   // See Finish() below for the serialization counterpart of this.
   // The root starts at the end of the buffer, so we parse backwards from there.
@@ -941,16 +902,398 @@ inline Reference GetRoot(const std::vector<uint8_t> &buffer) {
   return GetRoot(buffer.data(), buffer.size());
 }
 
+// The callbacks of Walk(). A visitor may derive from this to only define the
+// ones it needs, as they are looked up at compile time, not through virtual
+// functions.
+struct Visitor {
+  void Null() {}
+  void Bool(bool) {}
+  void Int(int64_t) {}
+  void UInt(uint64_t) {}
+  void Float(double) {}
+  // A value of type FBT_KEY, as found in vectors.
+  void Key(const char *) {}
+  void String(const char *, size_t) {}
+  void Blob(const uint8_t *, size_t) {}
+  // Vectors of any kind, the elements of which come between these two calls.
+  void StartVector(size_t) {}
+  void EndVector() {}
+  // Maps, with a call to MapKey() before each value.
+  void StartMap(size_t) {}
+  void MapKey(const char *) {}
+  void EndMap() {}
+  // A value of a type this version doesn't know about.
+  void Unknown(Type) {}
+};
+
+// Reads a value of `type` at `data`, with its children, for Walk().
+template<typename V>
+void WalkValue(const uint8_t *data, uint8_t parent_width, uint8_t byte_width,
+               Type type, V &visitor);
+
+// Reads the `len` elements of a typed vector, with the element type switched
+// on once rather than for each element.
+template<typename V>
+void WalkTypedElements(const uint8_t *data, size_t len, uint8_t byte_width,
+                       Type type, V &visitor) {
+  const uint8_t *end = data + len * byte_width;
+  switch (type) {
+    case FBT_INT:
+      for (; data < end; data += byte_width) {
+        visitor.Int(ReadInt64(data, byte_width));
+      }
+      break;
+    case FBT_UINT:
+      for (; data < end; data += byte_width) {
+        visitor.UInt(ReadUInt64(data, byte_width));
+      }
+      break;
+    case FBT_FLOAT:
+      for (; data < end; data += byte_width) {
+        visitor.Float(ReadDouble(data, byte_width));
+      }
+      break;
+    case FBT_BOOL:
+      for (; data < end; data += byte_width) {
+        visitor.Bool(ReadUInt64(data, byte_width) != 0);
+      }
+      break;
+    case FBT_KEY:
+      for (; data < end; data += byte_width) {
+        visitor.Key(reinterpret_cast<const char *>(Indirect(data, byte_width)));
+      }
+      break;
+    default:
+      // Elements of typed vectors have a byte width of 1, as with
+      // TypedVector::operator[].
+      for (; data < end; data += byte_width) {
+        WalkValue(data, byte_width, 1, type, visitor);
+      }
+  }
+}
+
+template<typename V>
+void WalkValue(const uint8_t *data, uint8_t parent_width, uint8_t byte_width,
+               Type type, V &visitor) {
+  switch (type) {
+    case FBT_NULL: visitor.Null(); return;
+    case FBT_INT: visitor.Int(ReadInt64(data, parent_width)); return;
+    case FBT_UINT: visitor.UInt(ReadUInt64(data, parent_width)); return;
+    case FBT_FLOAT: visitor.Float(ReadDouble(data, parent_width)); return;
+    case FBT_BOOL: visitor.Bool(ReadUInt64(data, parent_width) != 0); return;
+    default: break;
+  }
+  // All other types store an offset.
+  const uint8_t *indirect = Indirect(data, parent_width);
+  switch (type) {
+    case FBT_KEY: visitor.Key(reinterpret_cast<const char *>(indirect)); break;
+    case FBT_STRING:
+      visitor.String(reinterpret_cast<const char *>(indirect),
+                     static_cast<size_t>(
+                         ReadUInt64(indirect - byte_width, byte_width)));
+      break;
+    case FBT_INDIRECT_INT: visitor.Int(ReadInt64(indirect, byte_width)); break;
+    case FBT_INDIRECT_UINT:
+      visitor.UInt(ReadUInt64(indirect, byte_width));
+      break;
+    case FBT_INDIRECT_FLOAT:
+      visitor.Float(ReadDouble(indirect, byte_width));
+      break;
+    case FBT_BLOB:
+      visitor.Blob(indirect, static_cast<size_t>(ReadUInt64(
+                                 indirect - byte_width, byte_width)));
+      break;
+    case FBT_MAP: {
+      const uint8_t *keys_offset = indirect - byte_width * 3;
+      const uint8_t *keys = Indirect(keys_offset, byte_width);
+      const auto keys_width = static_cast<uint8_t>(
+          ReadUInt64(keys_offset + byte_width, byte_width));
+      const auto len =
+          static_cast<size_t>(ReadUInt64(keys - keys_width, keys_width));
+      const auto num_values = static_cast<size_t>(
+          ReadUInt64(indirect - byte_width, byte_width));
+      const uint8_t *types = indirect + num_values * byte_width;
+      visitor.StartMap(len);
+      for (size_t i = 0; i < len; i++) {
+        visitor.MapKey(reinterpret_cast<const char *>(
+            Indirect(keys + i * keys_width, keys_width)));
+        if (i < num_values) {
+          WalkValue(indirect + i * byte_width, byte_width,
+                    static_cast<uint8_t>(1 << (types[i] & 3)),
+                    static_cast<Type>(types[i] >> 2), visitor);
+        } else {
+          visitor.Null();
+        }
+      }
+      visitor.EndMap();
+      break;
+    }
+    case FBT_VECTOR: {
+      const auto len = static_cast<size_t>(
+          ReadUInt64(indirect - byte_width, byte_width));
+      const uint8_t *types = indirect + len * byte_width;
+      visitor.StartVector(len);
+      for (size_t i = 0; i < len; i++) {
+        WalkValue(indirect + i * byte_width, byte_width,
+                  static_cast<uint8_t>(1 << (types[i] & 3)),
+                  static_cast<Type>(types[i] >> 2), visitor);
+      }
+      visitor.EndVector();
+      break;
+    }
+    default:
+      if (IsTypedVector(type)) {
+        const auto len = static_cast<size_t>(
+            ReadUInt64(indirect - byte_width, byte_width));
+        visitor.StartVector(len);
+        WalkTypedElements(indirect, len, byte_width,
+                          ToTypedVectorElementType(type), visitor);
+        visitor.EndVector();
+      } else if (IsFixedTypedVector(type)) {
+        uint8_t len = 0;
+        const Type element_type = ToFixedTypedVectorElementType(type, &len);
+        visitor.StartVector(len);
+        WalkTypedElements(indirect, len, byte_width, element_type, visitor);
+        visitor.EndVector();
+      } else {
+        visitor.Unknown(type);
+      }
+  }
+}
+
+// Calls `visitor` (see Visitor) for `root` and every value in it, in order,
+// depth first. This reads each value once, without making a Reference, Vector
+// or Map for it, so it is the fastest way to go through all of a FlexBuffer.
+// Like the Reference accessors, it expects a buffer that has been verified.
+template<typename V> void Walk(const Reference &root, V &visitor) {
+  WalkValue(root.data_, root.parent_width_, root.byte_width_, root.type_,
+            visitor);
+}
+
+template<typename V>
+void Walk(const uint8_t *buffer, size_t size, V &visitor) {
+  Walk(GetRoot(buffer, size), visitor);
+}
+
+template<typename V>
+void Walk(const std::vector<uint8_t> &buffer, V &visitor) {
+  Walk(GetRoot(buffer), visitor);
+}
+
+// Appends the values it visits to a string, as JSON-like text. See
+// Reference::ToString().
+class ToStringVisitor : public Visitor {
+ public:
+  ToStringVisitor(std::string &s, bool strings_quoted, bool keys_quoted,
+                  bool indented, int cur_indent, const char *indent_string,
+                  bool natural_utf8)
+      : s_(s),
+        strings_quoted_(strings_quoted),
+        keys_quoted_(keys_quoted),
+        indented_(indented),
+        cur_indent_(cur_indent),
+        indent_string_(indent_string),
+        natural_utf8_(natural_utf8) {}
+
+  void Null() { Append("null"); }
+  void Bool(bool b) { Append(b ? "true" : "false"); }
+  void Int(int64_t i) {
+    Element();
+    if (i < 0) s_ += '-';
+    AppendDigits(i < 0 ? 0 - static_cast<uint64_t>(i)
+                       : static_cast<uint64_t>(i));
+  }
+  void UInt(uint64_t u) {
+    Element();
+    AppendDigits(u);
+  }
+  void Float(double d) { Append(flatbuffers::NumToString(d)); }
+  void Unknown(Type) { Append("(?)"); }
+
+  void Key(const char *key) {
+    Element();
+    if (keys_quoted_) {
+      flatbuffers::EscapeString(key, strlen(key), &s_, true, natural_utf8_);
+    } else {
+      s_ += key;
+    }
+  }
+
+  void String(const char *str, size_t len) {
+    Element();
+    // Strings inside other values are always quoted.
+    if (strings_quoted_ || !containers_.empty()) {
+      flatbuffers::EscapeString(str, len, &s_, true, natural_utf8_);
+    } else {
+      s_.append(str, len);
+    }
+  }
+
+  void Blob(const uint8_t *data, size_t len) {
+    Element();
+    flatbuffers::EscapeString(reinterpret_cast<const char *>(data), len, &s_,
+                              true, false);
+  }
+
+  void StartVector(size_t) { Start("[", false); }
+  void EndVector() { End("]", true); }
+  void StartMap(size_t) { Start("{", true); }
+  void EndMap() { End("}", containers_.back().count != 0); }
+
+  void MapKey(const char *key) {
+    Separate();
+    bool quoted = keys_quoted_;
+    if (!quoted) {
+      // FlexBuffers keys may contain arbitrary characters, only allow
+      // unquoted if it looks like an "identifier":
+      const char *p = key;
+      if (!flatbuffers::is_alpha(*p) && *p != '_') {
+        quoted = true;
+      } else {
+        while (*++p) {
+          if (!flatbuffers::is_alnum(*p) && *p != '_') {
+            quoted = true;
+            break;
+          }
+        }
+      }
+    }
+    if (quoted) {
+      flatbuffers::EscapeString(key, strlen(key), &s_, true, false);
+    } else {
+      s_ += key;
+    }
+    s_ += ": ";
+  }
+
+ private:
+  struct Container {
+    explicit Container(bool map) : is_map(map), count(0) {}
+    bool is_map;
+    size_t count;  // Elements so far.
+  };
+
+  void Append(const char *str) {
+    Element();
+    s_ += str;
+  }
+  void Append(const std::string &str) {
+    Element();
+    s_ += str;
+  }
+
+  // The same digits as NumToString(), without a std::stringstream per number,
+  // which would take most of the time for buffers of mostly integers.
+  void AppendDigits(uint64_t u) {
+    char digits[20];
+    char *p = digits + sizeof(digits);
+    do {
+      *--p = static_cast<char>('0' + u % 10);
+      u /= 10;
+    } while (u);
+    s_.append(p, digits + sizeof(digits));
+  }
+
+  // Comes before every value, which in vectors needs a separator.
+  void Element() {
+    if (!containers_.empty() && !containers_.back().is_map) Separate();
+  }
+
+  void Separate() {
+    if (containers_.back().count++) {
+      s_ += ",";
+      s_ += indented_ ? "\n" : " ";
+    }
+    Indent();
+  }
+
+  void Indent() {
+    if (indented_) {
+      IndentString(s_, cur_indent_ + static_cast<int>(containers_.size()),
+                   indent_string_);
+    }
+  }
+
+  void Start(const char *open, bool map) {
+    Element();
+    s_ += open;
+    s_ += indented_ ? "\n" : " ";
+    containers_.push_back(Container(map));
+  }
+
+  // An indented map only ends its last line if it has one.
+  void End(const char *close, bool end_line) {
+    containers_.pop_back();
+    if (indented_) {
+      if (end_line) s_ += "\n";
+      Indent();
+    } else {
+      s_ += " ";
+    }
+    s_ += close;
+  }
+
+  std::string &s_;
+  const bool strings_quoted_;
+  const bool keys_quoted_;
+  const bool indented_;
+  const int cur_indent_;
+  const char *indent_string_;
+  const bool natural_utf8_;
+  std::vector<Container> containers_;
+};
+
+inline void Reference::ToString(bool strings_quoted, bool keys_quoted,
+                                std::string &s, bool indented, int cur_indent,
+                                const char *indent_string,
+                                bool natural_utf8) const {
+  ToStringVisitor visitor(s, strings_quoted, keys_quoted, indented, cur_indent,
+                          indent_string, natural_utf8);
+  Walk(*this, visitor);
+}
+
+// Appends the elements of `v`, any vector of References, to `s` as a
+// JSON-like list, with each one converted by Reference::ToString().
+template<typename T>
+void AppendToString(std::string &s, T &&v, bool keys_quoted, bool indented,
+                    int cur_indent, const char *indent_string,
+                    bool natural_utf8) {
+  s += "[";
+  s += indented ? "\n" : " ";
+  for (size_t i = 0; i < v.size(); i++) {
+    if (i) {
+      s += ",";
+      s += indented ? "\n" : " ";
+    }
+    if (indented) IndentString(s, cur_indent, indent_string);
+    v[i].ToString(true, keys_quoted, s, indented, cur_indent, indent_string,
+                  natural_utf8);
+  }
+  if (indented) {
+    s += "\n";
+    IndentString(s, cur_indent - 1, indent_string);
+  } else {
+    s += " ";
+  }
+  s += "]";
+}
+
+template<typename T>
+void AppendToString(std::string &s, T &&v, bool keys_quoted) {
+  AppendToString(s, v, keys_quoted, false, 0, "", false);
+}
+
 // Flags that configure how the Builder behaves.
 // The "Share" flags determine if the Builder automatically tries to pool
 // this type. Pooling can reduce the size of serialized data if there are
 // multiple maps of the same kind, at the expense of slightly slower
-// serialization (the cost of lookups) and more memory use (std::set).
+// serialization (the cost of lookups) and more memory use (a hash table).
 // By default this is on for keys, but off for strings.
 // Turn keys off if you have e.g. only one map.
 // Turn strings on if you expect many non-unique string values.
 // Additionally, sharing key vectors can save space if you have maps with
-// identical field populations.
+// identical field populations. Only maps whose keys are shared can share their
+// key vectors, so this goes with BUILDER_FLAG_SHARE_KEYS.
 enum BuilderFlag {
   BUILDER_FLAG_NONE = 0,
   BUILDER_FLAG_SHARE_KEYS = 1,
@@ -968,9 +1311,7 @@ class Builder FLATBUFFERS_FINAL_CLASS {
         finished_(false),
         has_duplicate_keys_(false),
         flags_(flags),
-        force_min_bit_width_(BIT_WIDTH_8),
-        key_pool(KeyOffsetCompare(buf_)),
-        string_pool(StringOffsetCompare(buf_)) {
+        force_min_bit_width_(BIT_WIDTH_8) {
     buf_.clear();
   }
 
@@ -998,6 +1339,8 @@ class Builder FLATBUFFERS_FINAL_CLASS {
     force_min_bit_width_ = BIT_WIDTH_8;
     key_pool.clear();
     string_pool.clear();
+    key_vector_pool.clear();
+    maps_.clear();
   }
 
   // All value constructing functions below have two versions: one that
@@ -1074,16 +1417,15 @@ class Builder FLATBUFFERS_FINAL_CLASS {
     auto sloc = buf_.size();
     WriteBytes(str, len + 1);
     if (flags_ & BUILDER_FLAG_SHARE_KEYS) {
-      auto it = key_pool.find(sloc);
-      if (it != key_pool.end()) {
+      auto shared = ShareKey(sloc, len);
+      if (shared != sloc) {
         // Already in the buffer. Remove key we just serialized, and use
         // existing offset instead.
         buf_.resize(sloc);
-        sloc = *it;
-      } else {
-        key_pool.insert(sloc);
+        sloc = shared;
       }
     }
+    TrackKeyOrder(sloc);
     stack_.push_back(Value(static_cast<uint64_t>(sloc), FBT_KEY, BIT_WIDTH_8));
     return sloc;
   }
@@ -1095,16 +1437,13 @@ class Builder FLATBUFFERS_FINAL_CLASS {
     auto reset_to = buf_.size();
     auto sloc = CreateBlob(str, len, 1, FBT_STRING);
     if (flags_ & BUILDER_FLAG_SHARE_STRINGS) {
-      StringOffset so(sloc, len);
-      auto it = string_pool.find(so);
-      if (it != string_pool.end()) {
+      auto shared = ShareString(sloc, len, stack_.back().min_bit_width_);
+      if (shared != sloc) {
         // Already in the buffer. Remove string we just serialized, and use
         // existing offset instead.
         buf_.resize(reset_to);
-        sloc = it->first;
+        sloc = shared;
         stack_.back().u_ = sloc;
-      } else {
-        string_pool.insert(so);
       }
     }
     return sloc;
@@ -1150,20 +1489,28 @@ class Builder FLATBUFFERS_FINAL_CLASS {
   // e.g. Vector etc. Also in overloaded versions.
   // Also some FlatBuffers types?
 
-  size_t StartVector() { return stack_.size(); }
+  size_t StartVector() {
+    // Keys added to the vector are not keys of the map it is in.
+    if (!maps_.empty()) maps_.back().vectors++;
+    return stack_.size();
+  }
   size_t StartVector(const char *key) {
     Key(key);
+    return StartVector();
+  }
+  size_t StartMap() {
+    maps_.push_back(MapState(stack_.size()));
     return stack_.size();
   }
-  size_t StartMap() { return stack_.size(); }
   size_t StartMap(const char *key) {
     Key(key);
-    return stack_.size();
+    return StartMap();
   }
 
   // TODO(wvo): allow this to specify an alignment greater than the natural
   // alignment.
   size_t EndVector(size_t start, bool typed, bool fixed) {
+    if (!maps_.empty() && maps_.back().vectors) maps_.back().vectors--;
     auto vec = CreateVector(start, stack_.size() - start, 1, typed, fixed);
     // Remove temp elements and return vector.
     stack_.resize(start);
@@ -1178,43 +1525,14 @@ class Builder FLATBUFFERS_FINAL_CLASS {
     for (auto key = start; key < stack_.size(); key += 2) {
       FLATBUFFERS_ASSERT(stack_[key].type_ == FBT_KEY);
     }
-    // Now sort values, so later we can do a binary search lookup.
-    // We want to sort 2 array elements at a time.
-    struct TwoValue {
-      Value key;
-      Value val;
-    };
-    // TODO(wvo): strict aliasing?
-    // TODO(wvo): allow the caller to indicate the data is already sorted
-    // for maximum efficiency? With an assert to check sortedness to make sure
-    // we're not breaking binary search.
-    // Or, we can track if the map is sorted as keys are added which would be
-    // be quite cheap (cheaper than checking it here), so we can skip this
-    // step automatically when appliccable, and encourage people to write in
-    // sorted fashion.
-    // std::sort is typically already a lot faster on sorted data though.
-    auto dict = reinterpret_cast<TwoValue *>(stack_.data() + start);
-    std::sort(
-        dict, dict + len, [&](const TwoValue &a, const TwoValue &b) -> bool {
-          auto as = reinterpret_cast<const char *>(buf_.data() + a.key.u_);
-          auto bs = reinterpret_cast<const char *>(buf_.data() + b.key.u_);
-          auto comp = strcmp(as, bs);
-          // We want to disallow duplicate keys, since this results in a
-          // map where values cannot be found.
-          // But we can't assert here (since we don't want to fail on
-          // random JSON input) or have an error mechanism.
-          // Instead, we set has_duplicate_keys_ in the builder to
-          // signal this.
-          // TODO: Have to check for pointer equality, as some sort
-          // implementation apparently call this function with the same
-          // element?? Why?
-          if (!comp && &a != &b) has_duplicate_keys_ = true;
-          return comp < 0;
-        });
-    // First create a vector out of all keys.
-    // TODO(wvo): if kBuilderFlagShareKeyVectors is true, see if we can share
-    // the first vector.
-    auto keys = CreateVector(start, len, 2, true, false);
+    // Now sort values, so later we can do a binary search lookup. Keys added
+    // in order, which is common, need no sorting.
+    if (!EndMapState(start)) SortMap(start, len);
+    // First create a vector out of all keys, or find one made for an earlier
+    // map with the same keys.
+    auto keys = flags_ & BUILDER_FLAG_SHARE_KEY_VECTORS
+                    ? ShareKeyVector(start, len)
+                    : CreateVector(start, len, 2, true, false);
     auto vec = CreateVector(start + 1, len, 2, false, false, &keys);
     // Remove temp elements and return map.
     stack_.resize(start);
@@ -1661,6 +1979,136 @@ class Builder FLATBUFFERS_FINAL_CLASS {
                  bit_width);
   }
 
+  // Returns a keys vector for the sorted keys of a map, written earlier if
+  // possible. Keys are compared by offset, so this only finds vectors with
+  // the keys of the map in the same places, as with BUILDER_FLAG_SHARE_KEYS.
+  Value ShareKeyVector(size_t start, size_t len) {
+    uint64_t hash = len;
+    for (size_t i = 0; i < len; i++) {
+      hash = (hash ^ stack_[start + 2 * i].u_) * 0x100000001B3ULL;
+    }
+    const auto hash32 = static_cast<uint32_t>(hash ^ (hash >> 32));
+    const uint64_t *shared =
+        key_vector_pool.find(hash32, [&](uint64_t entry) {
+          return SameKeys(KeyVectorValue(entry), start, len);
+        });
+    if (shared) return KeyVectorValue(*shared);
+    const auto keys = CreateVector(start, len, 2, true, false);
+    key_vector_pool.insert(hash32, keys.u_ << 2 | keys.min_bit_width_);
+    return keys;
+  }
+
+  // The keys vector of an entry of `key_vector_pool`.
+  static Value KeyVectorValue(uint64_t entry) {
+    return Value(entry >> 2, ToTypedVector(FBT_KEY, 0),
+                 static_cast<BitWidth>(entry & 3));
+  }
+
+  // Whether the keys vector `keys` holds the keys of the map at `start`.
+  bool SameKeys(const Value &keys, size_t start, size_t len) const {
+    const auto byte_width = static_cast<uint8_t>(1U << keys.min_bit_width_);
+    const auto vloc = static_cast<size_t>(keys.u_);
+    if (ReadUInt64(buf_.data() + vloc - byte_width, byte_width) != len) {
+      return false;
+    }
+    for (size_t i = 0; i < len; i++) {
+      const auto eloc = vloc + i * byte_width;
+      if (eloc - ReadUInt64(buf_.data() + eloc, byte_width) !=
+          stack_[start + 2 * i].u_) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // A map started by StartMap() and not ended yet.
+  struct MapState {
+    explicit MapState(size_t start_)
+        : start(start_), vectors(0), sorted(true) {}
+    size_t start;    // Where its keys and values start on the stack.
+    size_t vectors;  // The number of vectors open in it.
+    bool sorted;     // Whether its keys so far were added in order.
+  };
+
+  const char *KeyAt(uint64_t sloc) const {
+    return reinterpret_cast<const char *>(buf_.data() + sloc);
+  }
+
+  // Compares the key at `sloc` with the one added before it to the innermost
+  // map, if any, unless it is a value or goes in a vector in the map.
+  void TrackKeyOrder(size_t sloc) {
+    if (maps_.empty()) return;
+    MapState &map = maps_.back();
+    const size_t pos = stack_.size() - map.start;
+    if (!map.sorted || map.vectors || pos < 2 || pos % 2) return;
+    const auto prev = stack_[stack_.size() - 2].u_;
+    const auto comp = prev == sloc ? 0 : strcmp(KeyAt(prev), KeyAt(sloc));
+    if (comp > 0) map.sorted = false;
+    // A map with duplicate keys has values that cannot be found, see
+    // HasDuplicateKeys().
+    if (comp == 0) has_duplicate_keys_ = true;
+  }
+
+  // Forgets the map that starts at `start`, and returns whether its keys were
+  // added in order. Maps that didn't come from StartMap() are not.
+  bool EndMapState(size_t start) {
+    while (!maps_.empty() && maps_.back().start > start) maps_.pop_back();
+    if (maps_.empty() || maps_.back().start != start) return false;
+    const bool sorted = maps_.back().sorted;
+    maps_.pop_back();
+    return sorted;
+  }
+
+  // A key of a map being sorted, with its first 8 bytes as a big-endian
+  // number, so most comparisons don't have to go to the buffer.
+  struct SortKey {
+    uint64_t prefix;
+    const char *rest;  // The key past the prefix, or null if it ends in it.
+    size_t index;      // Of the key in the map.
+  };
+
+  static int Compare(const SortKey &a, const SortKey &b) {
+    if (a.prefix != b.prefix) return a.prefix < b.prefix ? -1 : 1;
+    // Keys with equal prefixes either both end in them, or both go on.
+    return a.rest ? strcmp(a.rest, b.rest) : 0;
+  }
+
+  // Sorts the keys and values of a map by key, as strcmp() orders them.
+  void SortMap(size_t start, size_t len) {
+    sort_keys_.clear();
+    for (size_t i = 0; i < len; i++) {
+      const auto key = KeyAt(stack_[start + 2 * i].u_);
+      SortKey sort_key = { 0, nullptr, i };
+      size_t j = 0;
+      for (; j < sizeof(uint64_t) && key[j]; j++) {
+        sort_key.prefix |= static_cast<uint64_t>(static_cast<uint8_t>(key[j]))
+                           << (8 * (sizeof(uint64_t) - 1 - j));
+      }
+      if (j == sizeof(uint64_t)) sort_key.rest = key + j;
+      sort_keys_.push_back(sort_key);
+    }
+    std::sort(sort_keys_.begin(), sort_keys_.end(),
+              [&](const SortKey &a, const SortKey &b) -> bool {
+                const auto comp = Compare(a, b);
+                // We want to disallow duplicate keys, since this results in a
+                // map where values cannot be found.
+                // But we can't assert here (since we don't want to fail on
+                // random JSON input) or have an error mechanism.
+                // Instead, we set has_duplicate_keys_ in the builder to
+                // signal this.
+                // Some sort implementations compare an element with itself.
+                if (!comp && a.index != b.index) has_duplicate_keys_ = true;
+                return comp < 0;
+              });
+    sort_values_.assign(stack_.begin() + static_cast<std::ptrdiff_t>(start),
+                        stack_.begin() +
+                            static_cast<std::ptrdiff_t>(start + 2 * len));
+    for (size_t i = 0; i < len; i++) {
+      stack_[start + 2 * i] = sort_values_[2 * sort_keys_[i].index];
+      stack_[start + 2 * i + 1] = sort_values_[2 * sort_keys_[i].index + 1];
+    }
+  }
+
   // You shouldn't really be copying instances of this class.
   Builder(const Builder &);
   Builder &operator=(const Builder &);
@@ -1675,38 +2123,97 @@ class Builder FLATBUFFERS_FINAL_CLASS {
 
   BitWidth force_min_bit_width_;
 
-  struct KeyOffsetCompare {
-    explicit KeyOffsetCompare(const std::vector<uint8_t> &buf) : buf_(&buf) {}
-    bool operator()(size_t a, size_t b) const {
-      auto stra = reinterpret_cast<const char *>(buf_->data() + a);
-      auto strb = reinterpret_cast<const char *>(buf_->data() + b);
-      return strcmp(stra, strb) < 0;
-    }
-    const std::vector<uint8_t> *buf_;
-  };
+  // The offset of an earlier copy of the key of `len` bytes at `sloc`, or
+  // `sloc` itself, which is then added to the pool.
+  size_t ShareKey(size_t sloc, size_t len) {
+    const uint8_t *str = buf_.data() + sloc;
+    const uint32_t hash = HashBytes(str, len);
+    // Including the terminator, which ends the key at `loc` just the same.
+    // Both lie before the key at `sloc`, so within the buffer.
+    const size_t *shared = key_pool.find(hash, [&](size_t loc) {
+      return !memcmp(buf_.data() + loc, str, len + 1);
+    });
+    if (shared) return *shared;
+    key_pool.insert(hash, sloc);
+    return sloc;
+  }
+
+  // The same for the string at `sloc`, with a length prefix of `bit_width`.
+  size_t ShareString(size_t sloc, size_t len, BitWidth bit_width) {
+    const uint8_t *str = buf_.data() + sloc;
+    const uint32_t hash = HashBytes(str, len);
+    const uint64_t *shared = string_pool.find(hash, [&](uint64_t entry) {
+      const auto loc = static_cast<size_t>(entry >> 2);
+      const auto byte_width = static_cast<uint8_t>(1U << (entry & 3));
+      return ReadUInt64(buf_.data() + loc - byte_width, byte_width) == len &&
+             !memcmp(buf_.data() + loc, str, len);
+    });
+    if (shared) return static_cast<size_t>(*shared >> 2);
+    string_pool.insert(hash, static_cast<uint64_t>(sloc) << 2 | bit_width);
+    return sloc;
+  }
 
-  typedef std::pair<size_t, size_t> StringOffset;
-  struct StringOffsetCompare {
-    explicit StringOffsetCompare(const std::vector<uint8_t> &buf)
-        : buf_(&buf) {}
-    bool operator()(const StringOffset &a, const StringOffset &b) const {
-      auto stra = buf_->data() + a.first;
-      auto strb = buf_->data() + b.first;
-      auto cr = memcmp(stra, strb, (std::min)(a.second, b.second) + 1);
-      return cr < 0 || (cr == 0 && a.second < b.second);
+  // Mixes in 8 bytes at a time.
+  static uint32_t HashBytes(const uint8_t *str, size_t len) {
+    const uint64_t k = 0x9E3779B97F4A7C15ULL;
+    uint64_t hash = len * k;
+    for (;; str += 8) {
+      uint64_t word = 0;
+      memcpy(&word, str, (std::min)(len, sizeof(word)));
+      hash = (hash ^ word) * k;
+      hash ^= hash >> 32;
+      if (len <= sizeof(word)) return static_cast<uint32_t>(hash);
+      len -= sizeof(word);
     }
-    const std::vector<uint8_t> *buf_;
-  };
+  }
 
-  typedef std::set<size_t, KeyOffsetCompare> KeyOffsetMap;
-  typedef std::set<StringOffset, StringOffsetCompare> StringOffsetMap;
+  // The keys and strings in buf_ by a hash of their contents, to share them
+  // with. Strings are stored as their offset shifted left by 2, with the bit
+  // width of their length prefix below.
+  flatbuffers::OffsetHashSet<size_t> key_pool;
+  flatbuffers::OffsetHashSet<uint64_t> string_pool;
+  // Keys vectors by a hash of the offsets of their keys, each stored as its
+  // offset shifted left by 2, with the bit width of its elements below.
+  flatbuffers::OffsetHashSet<uint64_t> key_vector_pool;
 
-  KeyOffsetMap key_pool;
-  StringOffsetMap string_pool;
+  std::vector<MapState> maps_;
+  // Scratch space for SortMap().
+  std::vector<SortKey> sort_keys_;
+  std::vector<Value> sort_values_;
 
   friend class Verifier;
 };
 
+// Records what a Verifier has verified, like the `reuse_tracker` vector, but
+// in a hash table of the offsets of the vectors, strings and keys verified.
+// Its memory, and the time to clear it, are in proportion to their number
+// rather than to the size of the buffer. That makes it the faster of the two
+// for large buffers of large strings, blobs and vectors of scalars. For many
+// small objects it still takes less memory, but is slower, as looking them
+// up in order of offset is cheaper in the vector. It keeps its memory when
+// reused for another buffer.
+class SparseReuseTracker FLATBUFFERS_FINAL_CLASS {
+ public:
+  void Clear() { verified_.clear(); }
+
+  // The packed type the object at `offset` was verified as, or
+  // NullPackedType() if it was not, in which case it is recorded as `type`.
+  uint8_t Record(size_t offset, uint8_t type) {
+    const auto key = static_cast<uint64_t>(offset);
+    const auto hash =
+        static_cast<uint32_t>((key * 0x9E3779B97F4A7C15ULL) >> 32);
+    const uint64_t *verified = verified_.find(
+        hash, [&](uint64_t entry) { return entry >> 8 == key; });
+    if (verified) return static_cast<uint8_t>(*verified & 0xFF);
+    verified_.insert(hash, key << 8 | type);
+    return NullPackedType();
+  }
+
+ private:
+  // Offsets shifted left by 8, with their packed type below.
+  flatbuffers::OffsetHashSet<uint64_t> verified_;
+};
+
 // Helper class to verify the integrity of a FlexBuffer
 class Verifier FLATBUFFERS_FINAL_CLASS {
  public:
@@ -1724,7 +2231,8 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
         num_vectors_(0),
         max_vectors_(buf_len),
         check_alignment_(_check_alignment),
-        reuse_tracker_(reuse_tracker) {
+        reuse_tracker_(reuse_tracker),
+        sparse_reuse_tracker_(nullptr) {
     FLATBUFFERS_ASSERT(static_cast<int32_t>(size_) < FLATBUFFERS_MAX_BUFFER_SIZE);
     if (reuse_tracker_) {
       reuse_tracker_->clear();
@@ -1732,6 +2240,15 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
     }
   }
 
+  // The same, but tracking reuse in a SparseReuseTracker, for large buffers.
+  Verifier(const uint8_t *buf, size_t buf_len,
+           SparseReuseTracker &reuse_tracker, bool _check_alignment = true,
+           size_t max_depth = 64)
+      : Verifier(buf, buf_len, nullptr, _check_alignment, max_depth) {
+    sparse_reuse_tracker_ = &reuse_tracker;
+    sparse_reuse_tracker_->Clear();
+  }
+
  private:
   // Central location where any verification failures register.
   bool Check(bool ok) const {
@@ -1776,28 +2293,41 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
     return Check((o & (size - 1)) == 0 || !check_alignment_);
   }
 
+  // The type the reuse tracker has for the object at `p`, which it records as
+  // `type` if it has none yet.
+  uint8_t TrackReuse(const uint8_t *p, uint8_t type) {
+    if (sparse_reuse_tracker_) {
+      return sparse_reuse_tracker_->Record(static_cast<size_t>(p - buf_),
+                                           type);
+    }
+    uint8_t &slot = (*reuse_tracker_)[static_cast<size_t>(p - buf_)];
+    const uint8_t existing = slot;
+    if (!existing) slot = type;
+    return existing;
+  }
+
 // Macro, since we want to escape from parent function & use lazy args.
 #define FLEX_CHECK_VERIFIED(P, PACKED_TYPE)                     \
-  if (reuse_tracker_) {                                         \
+  if (reuse_tracker_ || sparse_reuse_tracker_) {                \
     auto packed_type = PACKED_TYPE;                             \
-    auto existing = (*reuse_tracker_)[P - buf_];                \
+    auto existing = TrackReuse(P, packed_type);                 \
     if (existing == packed_type) return true;                   \
     /* Fail verification if already set with different type! */ \
     if (!Check(existing == 0)) return false;                    \
-    (*reuse_tracker_)[P - buf_] = packed_type;                  \
   }
 
   bool VerifyVector(Reference r, const uint8_t *p, Type elem_type) {
     // Any kind of nesting goes thru this function, so guard against that
     // here, both with simple nesting checks, and the reuse tracker if on.
-    depth_++;
-    num_vectors_++;
-    if (!Check(depth_ <= max_depth_ && num_vectors_ <= max_vectors_))
-      return false;
     auto size_byte_width = r.byte_width_;
     if (!VerifyBeforePointer(p, size_byte_width)) return false;
+    // Before the nesting checks, as returning here skips undoing them.
     FLEX_CHECK_VERIFIED(p - size_byte_width,
                         PackedType(Builder::WidthB(size_byte_width), r.type_));
+    depth_++;
+    num_vectors_++;
+    if (!Check(depth_ <= max_depth_ && num_vectors_ <= max_vectors_))
+      return false;
     auto sized = Sized(p, size_byte_width);
     auto num_elems = sized.size();
     auto elem_byte_width = r.type_ == FBT_STRING || r.type_ == FBT_BLOB
@@ -1924,6 +2454,7 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
   const size_t max_vectors_;
   bool check_alignment_;
   std::vector<uint8_t> *reuse_tracker_;
+  SparseReuseTracker *sparse_reuse_tracker_;
 };
 
 // Utility function that constructs the Verifier for you, see above for
@@ -1934,6 +2465,12 @@ inline bool VerifyBuffer(const uint8_t *buf, size_t buf_len,
   return verifier.VerifyBuffer();
 }
 
+inline bool VerifyBuffer(const uint8_t *buf, size_t buf_len,
+                         SparseReuseTracker &reuse_tracker) {
+  Verifier verifier(buf, buf_len, reuse_tracker);
+  return verifier.VerifyBuffer();
+}
+
 }  // namespace flexbuffers
 
 #if defined(_MSC_VER)
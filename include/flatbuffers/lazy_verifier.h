@@ -0,0 +1,142 @@
+/*
+ * Copyright 2024 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLATBUFFERS_LAZY_VERIFIER_H_
+#define FLATBUFFERS_LAZY_VERIFIER_H_
+
+#include <map>
+
+#include "flatbuffers/base.h"
+#include "flatbuffers/buffer.h"
+#include "flatbuffers/vector.h"
+#include "flatbuffers/verifier.h"
+
+namespace flatbuffers {
+
+// Verifies the tables of a buffer one at a time, as they are read, so the
+// cost is proportional to the part of the buffer that is used:
+//
+//   LazyVerifier lazy(buf, len);
+//   const Monster *monster = lazy.GetRoot<Monster>(MonsterIdentifier());
+//   if (!monster) return false;
+//   // Fields of `monster` can be read as usual, but tables it refers to
+//   // must go through the verifier before they are used.
+//   const Monster *enemy = lazy.Get(monster->enemy());
+//   const Monster *first = lazy.Get(monster->testarrayoftables(), 0);
+//
+// Each table is verified by its generated Verify() in shallow mode (see
+// Verifier::SetShallow()), which checks everything but the tables, unions
+// and nested flatbuffers it refers to. Tables that pass are recorded in a
+// bitmap per type, so they are verified once however often they are read.
+// A table is only considered verified as the type it was verified as. Nested
+// flatbuffers need a LazyVerifier of their own.
+//
+// `max_tables` limits the number of tables verified over the lifetime of the
+// LazyVerifier, and each table counts as depth 1. Not thread-safe.
+class LazyVerifier {
+ public:
+  explicit LazyVerifier(const uint8_t *const buf, const size_t buf_len,
+                        const Verifier::Options &opts = Verifier::Options())
+      : buf_(buf),
+        size_(buf_len),
+        opts_(opts),
+        granularity_(opts.check_alignment ? sizeof(soffset_t) : 1),
+        num_tables_(0) {}
+
+  // Verifies the root table of the buffer, and returns it, or null if it is
+  // not valid.
+  template<typename T>
+  const T *GetRoot(const char *const identifier = nullptr) {
+    Verifier verifier(buf_, size_, opts_);
+    verifier.SetShallow(true);
+    if (!CountTable() || !verifier.VerifyBuffer<T>(identifier)) return nullptr;
+    const T *root = flatbuffers::GetRoot<T>(buf_);
+    Bitmap<T>()[Slot(root)] = true;
+    return root;
+  }
+
+  // Returns `table` once it is verified, or null if it is not valid. `table`
+  // must be null or come from a table returned by this LazyVerifier.
+  template<typename T> const T *Get(const T *const table) {
+    if (!table) return nullptr;
+    const auto tableo = static_cast<size_t>(
+        reinterpret_cast<const uint8_t *>(table) - buf_);
+    std::vector<bool> &verified = Bitmap<T>();
+    // Only a table at the start of a slot may be the one that was recorded.
+    const bool recordable = tableo < size_ && tableo % granularity_ == 0;
+    if (recordable && verified[tableo / granularity_]) return table;
+    Verifier verifier(buf_, size_, opts_);
+    verifier.SetShallow(true);
+    if (!CountTable() || !table->Verify(verifier)) return nullptr;
+    // Verify() checks alignment, if enabled, and that the table is inside the
+    // buffer.
+    FLATBUFFERS_ASSERT(recordable);
+    verified[tableo / granularity_] = true;
+    return table;
+  }
+
+  // Element `i` of a vector of tables, once it is verified. `vec` must come
+  // from a table returned by this LazyVerifier.
+  template<typename T>
+  const T *Get(const Vector<Offset<T>> *const vec, const uoffset_t i) {
+    return vec && i < vec->size() ? Get(vec->Get(i)) : nullptr;
+  }
+
+  // The number of tables verified so far, including ones that failed.
+  uoffset_t NumTablesVerified() const { return num_tables_; }
+
+ private:
+  // You shouldn't really be copying instances of this class.
+  FLATBUFFERS_DELETE_FUNC(LazyVerifier(const LazyVerifier &));
+  FLATBUFFERS_DELETE_FUNC(LazyVerifier &operator=(const LazyVerifier &));
+
+  // A distinct address per table type, to find its bitmap with.
+  template<typename T> struct TypeKey {
+    static const char key;
+  };
+
+  // One bit per place in the buffer a table of type T may start at, set once
+  // the table there is verified.
+  template<typename T> std::vector<bool> &Bitmap() {
+    std::vector<bool> &bitmap = bitmaps_[&TypeKey<T>::key];
+    if (bitmap.empty()) bitmap.resize(size_ / granularity_ + 1);
+    return bitmap;
+  }
+
+  size_t Slot(const void *const table) const {
+    return static_cast<size_t>(static_cast<const uint8_t *>(table) - buf_) /
+           granularity_;
+  }
+
+  bool CountTable() {
+    if (num_tables_ >= opts_.max_tables) return false;
+    num_tables_++;
+    return true;
+  }
+
+  const uint8_t *buf_;
+  const size_t size_;
+  const Verifier::Options opts_;
+  const size_t granularity_;
+  uoffset_t num_tables_;
+  std::map<const void *, std::vector<bool>> bitmaps_;
+};
+
+template<typename T> const char LazyVerifier::TypeKey<T>::key = 0;
+
+}  // namespace flatbuffers
+
+#endif  // FLATBUFFERS_LAZY_VERIFIER_H_
@@ -0,0 +1,178 @@
+/*
+ * Copyright 2024 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLATBUFFERS_OFFSET_HASH_SET_H_
+#define FLATBUFFERS_OFFSET_HASH_SET_H_
+
+#include <new>
+
+#include "flatbuffers/allocator.h"
+#include "flatbuffers/base.h"
+#include "flatbuffers/default_allocator.h"
+
+namespace flatbuffers {
+
+// 32-bit FNV-1a over `len` bytes. Unlike `HashFnv1a` in hash.h, this takes an
+// explicit length, so it works on binary data with embedded nulls.
+inline uint32_t HashFnv1aBytes(const void *data, size_t len) {
+  auto bytes = static_cast<const uint8_t *>(data);
+  uint32_t hash = 0x811C9DC5;
+  for (size_t i = 0; i < len; i++) {
+    hash ^= bytes[i];
+    hash *= 0x01000193;
+  }
+  return hash;
+}
+
+// An open-addressing hash set of offsets into a buffer under construction.
+// Builders use it to find data they have serialized before (vtables, shared
+// strings), without allocating a node per entry like std::set does.
+// Only offsets and their hashes are stored: the caller passes the hash of the
+// data it is looking for, and an equality functor that compares it against
+// the serialized data at a candidate offset.
+// Slots come from `allocator` (or the default allocator if null), and are
+// kept when the set is cleared, so it can be reused across buffers.
+template<typename OffsetT> class OffsetHashSet {
+ public:
+  explicit OffsetHashSet(Allocator *allocator = nullptr)
+      : allocator_(allocator), slots_(nullptr), capacity_(0), size_(0) {}
+
+  OffsetHashSet(OffsetHashSet &&other) noexcept
+      : allocator_(other.allocator_),
+        slots_(other.slots_),
+        capacity_(other.capacity_),
+        size_(other.size_) {
+    other.slots_ = nullptr;
+    other.capacity_ = 0;
+    other.size_ = 0;
+  }
+
+  OffsetHashSet &operator=(OffsetHashSet &&other) noexcept {
+    // Move construct a temporary and swap idiom
+    OffsetHashSet temp(std::move(other));
+    swap(temp);
+    return *this;
+  }
+
+  ~OffsetHashSet() { reset(); }
+
+  void swap(OffsetHashSet &other) {
+    using std::swap;
+    swap(allocator_, other.allocator_);
+    swap(slots_, other.slots_);
+    swap(capacity_, other.capacity_);
+    swap(size_, other.size_);
+  }
+
+  // Remove all entries, keeping the slots for reuse.
+  void clear() {
+    for (size_t i = 0; i < capacity_; i++) slots_[i] = Slot();
+    size_ = 0;
+  }
+
+  // Remove all entries and release the slots.
+  void reset() {
+    if (slots_) {
+      Deallocate(allocator_, reinterpret_cast<uint8_t *>(slots_),
+                 capacity_ * sizeof(Slot));
+    }
+    slots_ = nullptr;
+    capacity_ = 0;
+    size_ = 0;
+  }
+
+  size_t size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  // Returns nullptr if using the DefaultAllocator.
+  Allocator *get_custom_allocator() { return allocator_; }
+
+  // Returns a pointer to the first stored offset with the given `hash` for
+  // which `equal(offset)` returns true, or nullptr if there is none.
+  template<typename EqualT>
+  const OffsetT *find(const uint32_t hash, const EqualT &equal) const {
+    if (!size_) return nullptr;
+    const size_t mask = capacity_ - 1;
+    for (size_t i = hash & mask; slots_[i].offset != kEmpty;
+         i = (i + 1) & mask) {
+      if (slots_[i].hash == hash && equal(slots_[i].offset)) {
+        return &slots_[i].offset;
+      }
+    }
+    return nullptr;
+  }
+
+  // Stores `offset` under `hash`. Does not check for duplicates, call find()
+  // first.
+  void insert(const uint32_t hash, const OffsetT offset) {
+    FLATBUFFERS_ASSERT(offset != kEmpty);
+    // Keep the load factor at or below 1/2, so probe sequences stay short.
+    if ((size_ + 1) * 2 > capacity_) grow();
+    place(slots_, capacity_, hash, offset);
+    size_++;
+  }
+
+ private:
+  // You shouldn't really be copying instances of this class.
+  FLATBUFFERS_DELETE_FUNC(OffsetHashSet(const OffsetHashSet &));
+  FLATBUFFERS_DELETE_FUNC(OffsetHashSet &operator=(const OffsetHashSet &));
+
+  // No valid offset into a buffer is all ones, so it marks unused slots.
+  static const OffsetT kEmpty = static_cast<OffsetT>(~static_cast<OffsetT>(0));
+
+  struct Slot {
+    Slot() : hash(0), offset(kEmpty) {}
+    uint32_t hash;
+    OffsetT offset;
+  };
+
+  static void place(Slot *slots, size_t capacity, uint32_t hash,
+                    OffsetT offset) {
+    const size_t mask = capacity - 1;
+    size_t i = hash & mask;
+    while (slots[i].offset != kEmpty) i = (i + 1) & mask;
+    slots[i].hash = hash;
+    slots[i].offset = offset;
+  }
+
+  void grow() {
+    const size_t new_capacity = capacity_ ? capacity_ * 2 : 64;
+    auto new_slots = reinterpret_cast<Slot *>(
+        Allocate(allocator_, new_capacity * sizeof(Slot)));
+    for (size_t i = 0; i < new_capacity; i++) new (&new_slots[i]) Slot();
+    // The stored hashes make rehashing possible without touching the buffer.
+    for (size_t i = 0; i < capacity_; i++) {
+      if (slots_[i].offset != kEmpty) {
+        place(new_slots, new_capacity, slots_[i].hash, slots_[i].offset);
+      }
+    }
+    const size_t old_size = size_;
+    reset();
+    slots_ = new_slots;
+    capacity_ = new_capacity;
+    size_ = old_size;
+  }
+
+  Allocator *allocator_;
+  Slot *slots_;
+  size_t capacity_;  // Always 0 or a power of 2.
+  size_t size_;
+};
+
+}  // namespace flatbuffers
+
+#endif  // FLATBUFFERS_OFFSET_HASH_SET_H_
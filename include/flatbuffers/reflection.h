@@ -518,6 +518,101 @@ bool VerifySizePrefixed(const reflection::Schema &schema,
                         size_t length, uoffset_t max_depth = 64,
                         uoffset_t max_tables = 1000000);
 
+// Verifies buffers using reflection like Verify() above, but with the schema
+// compiled up front into a flat list of checks per table, so verifying a
+// buffer does not look anything up in the schema. Build one per schema, and
+// reuse it for every buffer. The schema is not used after construction.
+//
+// It checks what generated code does, except for nested flatbuffers and
+// flexbuffers. Unlike Verify(), that includes the root offset, the file
+// identifier of the schema, `required` on all fields, and 64-bit offsets and
+// vectors, while deprecated fields and union types unknown to the schema are
+// skipped.
+class ReflectionVerifier {
+ public:
+  explicit ReflectionVerifier(const reflection::Schema &schema);
+
+  // Verifies a buffer with the root table and file identifier of the schema.
+  bool Verify(const uint8_t *buf, size_t length,
+              const Verifier::Options &opts = Verifier::Options()) const;
+
+  // Verifies a buffer with the table at `object_index` in the schema's
+  // objects() as its root, and any file identifier.
+  bool Verify(uoffset_t object_index, const uint8_t *buf, size_t length,
+              const Verifier::Options &opts = Verifier::Options()) const;
+
+  bool VerifySizePrefixed(
+      const uint8_t *buf, size_t length,
+      const Verifier::Options &opts = Verifier::Options()) const;
+
+ private:
+  enum OpKind : uint8_t {
+    kScalar,  // Also structs.
+    kString,
+    kVector,  // Of scalars or structs.
+    kVectorOfStrings,
+    kVectorOfTables,
+    kTable,
+    kUnion,
+    kVectorOfUnions,
+  };
+
+  // How offsets and vector lengths of a field are stored.
+  enum Width : uint8_t {
+    k32,
+    kOffset64,  // A 64-bit offset to a string or vector with 32-bit length.
+    kVector64,  // A 64-bit offset to a vector with 64-bit length.
+  };
+
+  // A check of a single field of a table.
+  struct Op {
+    OpKind kind;
+    Width width;
+    bool required;
+    voffset_t field;  // Its vtable offset.
+    uint32_t size;    // Of the scalar or struct, or vector elements.
+    uint32_t align;
+    uint32_t index;   // Into `tables_`, or into `unions_` for unions.
+  };
+
+  // What a union value refers to, by its type.
+  struct UnionMember {
+    enum Kind : uint8_t { kUnknown, kNone, kTable, kStruct, kString } kind;
+    uint32_t index;  // Into `tables_` for tables, the size for structs.
+    uint32_t align;  // Of structs.
+    int64_t value;   // Its type.
+  };
+
+  // The `ops_` of a table, or the `members_` of a union.
+  struct Range {
+    uint32_t begin;
+    uint32_t end;
+  };
+
+  // A union's `members_` are indexed by type value when all values fit in a
+  // byte, and otherwise sorted by it, like those with an `int` type.
+  struct Union {
+    Range members;
+    reflection::BaseType type;  // Of the type field.
+    bool sorted;
+  };
+
+  bool VerifyRoot(Verifier &v, const uint8_t *buf, size_t length,
+                  uoffset_t object_index, const char *identifier,
+                  size_t start) const;
+  bool VerifyTable(Verifier &v, uint32_t index, const Table *table) const;
+  bool VerifyUnion(Verifier &v, uint32_t index, int64_t type,
+                   const uint8_t *value) const;
+
+  std::vector<Op> ops_;
+  std::vector<Range> tables_;  // By object index, empty for structs.
+  std::vector<bool> is_struct_;
+  std::vector<UnionMember> members_;
+  std::vector<Union> unions_;  // By enum index, empty for other enums.
+  int32_t root_;               // The root table, or -1 if none.
+  std::string file_ident_;
+};
+
 }  // namespace flatbuffers
 
 #endif  // FLATBUFFERS_REFLECTION_H_
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2024 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLATBUFFERS_STREAM_VERIFIER_H_
+#define FLATBUFFERS_STREAM_VERIFIER_H_
+
+#include "flatbuffers/base.h"
+#include "flatbuffers/verifier.h"
+
+namespace flatbuffers {
+
+// Verifies back-to-back size prefixed buffers with root type T, as read from
+// a file or socket, in batches:
+//
+//   SizePrefixedStreamVerifier<Monster> stream(MonsterIdentifier());
+//   const size_t used = stream.Verify(data, len);
+//   for (size_t offset : stream.valid()) {
+//     const Monster *monster = GetSizePrefixedMonster(data + offset);
+//   }
+//   // Keep data[used, len) and read more after it.
+//
+// Each buffer is verified on its own, as if by VerifySizePrefixedBuffer().
+// With an executor (see Verifier::SetExecutor()), all the size prefixes are
+// read first, then the buffers are verified in parallel, which also spreads
+// large buffers over several threads.
+template<typename T, typename SizeT = uoffset_t>
+class SizePrefixedStreamVerifier {
+ public:
+  explicit SizePrefixedStreamVerifier(
+      const char *const identifier = nullptr,
+      const Verifier::Options &opts = Verifier::Options())
+      : identifier_(identifier),
+        opts_(opts),
+        executor_(nullptr),
+        num_invalid_(0),
+        framed_(true) {}
+
+  // Verifies the buffers at the start of `buf`, and returns the number of
+  // bytes they take up. A buffer that is cut short by the end of `buf` is
+  // left for the next call, once the rest of it has been read.
+  size_t Verify(const uint8_t *const buf, const size_t len) {
+    valid_.clear();
+    num_invalid_ = 0;
+    // Framing has to go through the prefixes one by one, as each tells where
+    // the next is. Serially, each buffer is verified right away, while it is
+    // in cache.
+    frames_.clear();
+    framed_ = true;
+    size_t offset = 0;
+    while (len - offset >= sizeof(SizeT)) {
+      // Compared before adding the prefix itself, which could overflow.
+      const SizeT prefix = ReadScalar<SizeT>(buf + offset);
+      // Such a buffer can never be verified, and without knowing where it
+      // ends, neither can the ones after it.
+      framed_ = opts_.max_size > sizeof(SizeT) &&
+                prefix < opts_.max_size - sizeof(SizeT);
+      if (!framed_ || prefix > len - offset - sizeof(SizeT)) break;
+      const size_t size = static_cast<size_t>(prefix) + sizeof(SizeT);
+      if (executor_) {
+        frames_.push_back(offset);
+      } else {
+        Record(offset, VerifyOne(buf + offset, size));
+      }
+      offset += size;
+    }
+    if (!frames_.empty()) {
+      frames_.push_back(offset);
+      VerifyFrames(buf);
+    }
+    return offset;
+  }
+
+  // The offsets of the valid buffers found by the last Verify(), at their
+  // size prefix.
+  const std::vector<size_t> &valid() const { return valid_; }
+
+  // The number of buffers the last Verify() found to be invalid.
+  size_t num_invalid() const { return num_invalid_; }
+
+  // False if the last Verify() stopped at a size prefix of `max_size` or
+  // more, after which the stream can't be split into buffers anymore.
+  bool framed() const { return framed_; }
+
+  // Verify buffers in parallel on `executor` (not owned), or serially if null.
+  void SetExecutor(VerifierExecutor *const executor) { executor_ = executor; }
+
+ private:
+  bool VerifyOne(const uint8_t *const buf, const size_t size) const {
+    Verifier verifier(buf, size, opts_);
+    verifier.SetExecutor(executor_);
+    return verifier.template VerifySizePrefixedBuffer<T, SizeT>(identifier_);
+  }
+
+  void Record(const size_t offset, const bool ok) {
+    if (ok) {
+      valid_.push_back(offset);
+    } else {
+      num_invalid_++;
+    }
+  }
+
+  // Verifies the buffers between `frames_` in parallel.
+  void VerifyFrames(const uint8_t *const buf) {
+    const size_t num_frames = frames_.size() - 1;
+    ok_.assign(num_frames, 0);
+    // A few tasks per thread, to balance buffers of different sizes.
+    const size_t num_tasks =
+        (std::min)(num_frames, 4 * executor_->Concurrency());
+    executor_->ParallelFor(num_tasks, [&](size_t t) {
+      for (size_t i = num_frames * t / num_tasks;
+           i < num_frames * (t + 1) / num_tasks; i++) {
+        ok_[i] = VerifyOne(buf + frames_[i], frames_[i + 1] - frames_[i]);
+      }
+    });
+    for (size_t i = 0; i < num_frames; i++) Record(frames_[i], ok_[i] != 0);
+  }
+
+  const char *const identifier_;
+  const Verifier::Options opts_;
+  VerifierExecutor *executor_;
+  // Where each complete buffer starts, and the last one ends.
+  std::vector<size_t> frames_;
+  std::vector<uint8_t> ok_;  // Whether each buffer in `frames_` is valid.
+  std::vector<size_t> valid_;
+  size_t num_invalid_;
+  bool framed_;
+};
+
+}  // namespace flatbuffers
+
+#endif  // FLATBUFFERS_STREAM_VERIFIER_H_
@@ -131,6 +131,21 @@ class Table {
     return !field_offset || verifier.VerifyField<T>(data_, field_offset, align);
   }
 
+  // Verify all scalar and struct fields at once, instead of calling
+  // VerifyField for each, using a single range check. `sizes` and `aligns`
+  // hold the size and alignment of the field in each vtable slot, with size 0
+  // for fields verified by other means.
+  template<size_t N>
+  bool VerifyInlineFields(const Verifier &verifier, const voffset_t (&sizes)[N],
+                          const voffset_t (&aligns)[N]) const {
+    auto vtable = GetVTable();
+    // The first two elements are the vtable and table sizes, the rest fields.
+    const size_t vt_elems = ReadScalar<voffset_t>(vtable) / sizeof(voffset_t);
+    return verifier.VerifyInlineFields(data_, vtable + 2 * sizeof(voffset_t),
+                                       vt_elems > 2 ? vt_elems - 2 : 0, sizes,
+                                       aligns);
+  }
+
   // VerifyField for required fields.
   template<typename T>
   bool VerifyFieldRequired(const Verifier &verifier, voffset_t field,
@@ -183,6 +198,85 @@ inline flatbuffers::Optional<bool> Table::GetOptional<uint8_t, bool>(
                       : Optional<bool>();
 }
 
+// A table with the field offsets of its vtable copied out once, so reading
+// a field doesn't go through the vtable again. Worth it when reading most
+// fields of a table, such as in a loop over a vector of tables. `N` is the
+// number of vtable slots of the table type. Fields past the end of an older
+// vtable read as absent, and ones a newer vtable has past `N` are ignored.
+// The accessors are those of Table, see --gen-table-view.
+template<size_t N> class TableView {
+ public:
+  explicit TableView(const Table *table)
+      : data_(reinterpret_cast<const uint8_t *>(table)) {
+    const uint8_t *vtable = data_ - ReadScalar<soffset_t>(data_);
+    // The first two elements are the vtable and table sizes, the rest fields.
+    const size_t vt_elems = ReadScalar<voffset_t>(vtable) / sizeof(voffset_t);
+    const uint8_t *slots = vtable + 2 * sizeof(voffset_t);
+    // Loops of constant length where possible, so they unroll and the
+    // offsets can live in registers.
+    if (vt_elems >= N + 2) {
+      for (size_t i = 0; i < N; i++) {
+        offsets_[i] = ReadScalar<voffset_t>(slots + i * sizeof(voffset_t));
+      }
+    } else {
+      for (size_t i = 0; i < N; i++) {
+        offsets_[i] = i + 2 < vt_elems ? ReadScalar<voffset_t>(
+                                             slots + i * sizeof(voffset_t))
+                                       : 0;
+      }
+    }
+  }
+
+  voffset_t GetOptionalFieldOffset(voffset_t field) const {
+    return offsets_[field / sizeof(voffset_t) - 2];
+  }
+
+  template<typename T> T GetField(voffset_t field, T defaultval) const {
+    auto field_offset = GetOptionalFieldOffset(field);
+    return field_offset ? ReadScalar<T>(data_ + field_offset) : defaultval;
+  }
+
+  template<typename P, typename OffsetSize = uoffset_t>
+  P GetPointer(voffset_t field) const {
+    auto field_offset = GetOptionalFieldOffset(field);
+    auto p = data_ + field_offset;
+    return field_offset ? reinterpret_cast<P>(p + ReadScalar<OffsetSize>(p))
+                        : nullptr;
+  }
+
+  template<typename P> P GetPointer64(voffset_t field) const {
+    return GetPointer<P, uoffset64_t>(field);
+  }
+
+  template<typename P> P GetStruct(voffset_t field) const {
+    auto field_offset = GetOptionalFieldOffset(field);
+    return field_offset ? reinterpret_cast<P>(data_ + field_offset) : nullptr;
+  }
+
+  template<typename Raw, typename Face>
+  flatbuffers::Optional<Face> GetOptional(voffset_t field) const {
+    auto field_offset = GetOptionalFieldOffset(field);
+    return field_offset ? Optional<Face>(
+                              ToFace(ReadScalar<Raw>(data_ + field_offset),
+                                     static_cast<Face *>(nullptr)))
+                        : Optional<Face>();
+  }
+
+  bool CheckField(voffset_t field) const {
+    return GetOptionalFieldOffset(field) != 0;
+  }
+
+ private:
+  template<typename Raw, typename Face> static Face ToFace(Raw raw, Face *) {
+    return static_cast<Face>(raw);
+  }
+  // As for Table::GetOptional(), this avoids a cast MSVC warns about.
+  static bool ToFace(uint8_t raw, bool *) { return raw != 0; }
+
+  const uint8_t *data_;
+  voffset_t offsets_[N];
+};
+
 }  // namespace flatbuffers
 
 #endif  // FLATBUFFERS_TABLE_H_
@@ -277,18 +277,30 @@ template<typename T, typename SizeT = uoffset_t> class Vector {
   const T *data() const { return reinterpret_cast<const T *>(Data()); }
   T *data() { return reinterpret_cast<T *>(Data()); }
 
+  // Finds the element with key `key` in a vector sorted by key, or returns
+  // null. Keys compare through the KeyCompareWithValue() of the elements.
   template<typename K> return_type LookupByKey(K key) const {
-    void *search_result = std::bsearch(
-        &key, Data(), size(), IndirectHelper<T>::element_stride, KeyCompare<K>);
-
-    if (!search_result) {
-      return nullptr;  // Key not found.
-    }
-
-    const uint8_t *element = reinterpret_cast<const uint8_t *>(search_result);
+    const uint8_t *element = Find([&](const uint8_t *e) {
+      return IndirectHelper<T>::Read(e, 0)->KeyCompareWithValue(key);
+    });
+    return element ? IndirectHelper<T>::Read(element, 0) : nullptr;
+  }
 
-    return IndirectHelper<T>::Read(element, 0);
+  // String keys of elements with a KeyString() are compared as
+  // String::operator< does, which sorted the vector, rather than with
+  // strcmp(), so the key is measured only once. Other elements, such as those
+  // of code generated by an older flatc, use KeyCompareWithValue().
+  return_type LookupByKey(const char *key) const {
+    return LookupByStringKey(key, key_string_tag());
+  }
+  return_type LookupByKey(const std::string &key) const {
+    return LookupByStringKey(key, key_string_tag());
   }
+#ifdef FLATBUFFERS_HAS_STRING_VIEW
+  return_type LookupByKey(flatbuffers::string_view key) const {
+    return LookupByStringKey(key, key_string_tag());
+  }
+#endif  // FLATBUFFERS_HAS_STRING_VIEW
 
   template<typename K> mutable_return_type MutableLookupByKey(K key) {
     return const_cast<mutable_return_type>(LookupByKey(key));
@@ -307,14 +319,82 @@ template<typename T, typename SizeT = uoffset_t> class Vector {
   Vector(const Vector &);
   Vector &operator=(const Vector &);
 
-  template<typename K> static int KeyCompare(const void *ap, const void *bp) {
-    const K *key = reinterpret_cast<const K *>(ap);
-    const uint8_t *data = reinterpret_cast<const uint8_t *>(bp);
-    auto table = IndirectHelper<T>::Read(data, 0);
-
-    // std::bsearch compares with the operands transposed, so we negate the
-    // result here.
-    return -table->KeyCompareWithValue(*key);
+  // Returns the element for which `compare` returns 0, or null if there is
+  // none. The vector must be sorted so that `compare` is negative for the
+  // elements before it and positive for the ones after. `compare` takes a
+  // pointer to the element, as stored in the vector.
+  template<typename Compare> const uint8_t *Find(Compare compare) const {
+    const size_t stride = IndirectHelper<T>::element_stride;
+    const uint8_t *base = Data();
+    size_t n = size();
+    if (!IsConstTrue(scalar_tag::value)) {
+      // The key of a table is several dependent loads away. Branching lets
+      // the CPU start on the next step while they are in flight, and stop
+      // early at the key.
+      while (n > 0) {
+        const size_t half = n / 2;
+        const uint8_t *mid = base + half * stride;
+        const int c = compare(mid);
+        if (c == 0) return mid;
+        if (c < 0) {
+          base = mid + stride;
+          n -= half + 1;
+        } else {
+          n = half;
+        }
+      }
+      return nullptr;
+    }
+    // Keys stored in the vector, as in structs, are one load away. Which half
+    // comes next can't be predicted, so it is picked with a conditional move,
+    // and vectors too large to be in cache have both candidates of the step
+    // after prefetched.
+    if (n == 0) return nullptr;
+    const size_t prefetch_bytes = 64 * 1024;
+    while (n > 1) {
+      const size_t half = n / 2;
+      if (n * stride > prefetch_bytes) {
+        FLATBUFFERS_PREFETCH(base + (half / 2) * stride);
+        FLATBUFFERS_PREFETCH(base + (half + half / 2) * stride);
+      }
+      const uint8_t *mid = base + half * stride;
+      base = compare(mid) < 0 ? mid : base;
+      n -= half;
+    }
+    // `base` is the last element before the key, or the first one.
+    if (compare(base) < 0) base += stride;
+    return base < Data() + size() * stride && compare(base) == 0 ? base
+                                                                 : nullptr;
+  }
+
+  template<typename R>
+  static auto HasKeyString(int)
+      -> decltype(std::declval<R>()->KeyString(), flatbuffers::true_type());
+  template<typename R> static flatbuffers::false_type HasKeyString(...);
+  typedef decltype(HasKeyString<return_type>(0)) key_string_tag;
+
+  template<typename K>
+  return_type LookupByStringKey(const K &key, flatbuffers::false_type) const {
+    return LookupByKey<K>(key);
+  }
+  return_type LookupByStringKey(const char *key,
+                                flatbuffers::true_type) const {
+    return FindByKeyString(key, strlen(key));
+  }
+  template<typename K>
+  return_type LookupByStringKey(const K &key, flatbuffers::true_type) const {
+    return FindByKeyString(key.data(), key.size());
+  }
+
+  return_type FindByKeyString(const char *key, size_t key_size) const {
+    const uint8_t *element = Find([&](const uint8_t *e) {
+      const auto *s = IndirectHelper<T>::Read(e, 0)->KeyString();
+      const size_t size = s->size();
+      const int c = memcmp(s->data(), key, (std::min)(size, key_size));
+      return c != 0 ? c : static_cast<int>(size > key_size) -
+                              static_cast<int>(size < key_size);
+    });
+    return element ? IndirectHelper<T>::Read(element, 0) : nullptr;
   }
 };
 
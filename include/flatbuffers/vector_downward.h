@@ -19,6 +19,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <vector>
 
 #include "flatbuffers/base.h"
 #include "flatbuffers/default_allocator.h"
@@ -32,6 +33,15 @@ namespace flatbuffers {
 // Since this vector leaves the lower part unused, we support a "scratch-pad"
 // that can be stored there for temporary data, to share the allocated space.
 // Essentially, this supports 2 std::vectors in a single buffer.
+//
+// In chunked mode, growing starts a new chunk below the existing data instead
+// of copying it all to a larger buffer, so the data is spread over several
+// chunks until flatten() is called. Only the object under construction (the
+// data since the last mark_object()) and the scratch-pad are moved to the new
+// chunk, so that every object stays contiguous. data_at() only reaches the
+// newest chunk, chunked_data_at() any of them.
+// flush() hands the data written so far to a sink and frees it, after which
+// only the data written since is kept, and offsets keep counting from the end.
 template<typename SizeT = uoffset_t> class vector_downward {
  public:
   explicit vector_downward(size_t initial_size, Allocator *allocator,
@@ -46,7 +56,13 @@ template<typename SizeT = uoffset_t> class vector_downward {
         size_(0),
         buf_(nullptr),
         cur_(nullptr),
-        scratch_(nullptr) {}
+        scratch_(nullptr),
+        chunked_(false),
+        mark_(0),
+        base_(0),
+        pad_(0),
+        flushed_(0),
+        total_reserved_(0) {}
 
   vector_downward(vector_downward &&other) noexcept
       // clang-format on
@@ -59,7 +75,14 @@ template<typename SizeT = uoffset_t> class vector_downward {
         size_(other.size_),
         buf_(other.buf_),
         cur_(other.cur_),
-        scratch_(other.scratch_) {
+        scratch_(other.scratch_),
+        chunked_(other.chunked_),
+        mark_(other.mark_),
+        base_(other.base_),
+        pad_(other.pad_),
+        flushed_(other.flushed_),
+        total_reserved_(other.total_reserved_),
+        chunks_(std::move(other.chunks_)) {
     // No change in other.allocator_
     // No change in other.initial_size_
     // No change in other.buffer_minalign_
@@ -68,6 +91,10 @@ template<typename SizeT = uoffset_t> class vector_downward {
     other.buf_ = nullptr;
     other.cur_ = nullptr;
     other.scratch_ = nullptr;
+    other.base_ = 0;
+    other.flushed_ = 0;
+    other.total_reserved_ = 0;
+    other.chunks_.clear();
   }
 
   vector_downward &operator=(vector_downward &&other) noexcept {
@@ -88,6 +115,8 @@ template<typename SizeT = uoffset_t> class vector_downward {
   }
 
   void clear() {
+    // Only the newest (and largest) chunk is kept for reuse.
+    clear_chunks();
     if (buf_) {
       cur_ = buf_ + reserved_;
     } else {
@@ -95,6 +124,11 @@ template<typename SizeT = uoffset_t> class vector_downward {
       cur_ = nullptr;
     }
     size_ = 0;
+    mark_ = 0;
+    base_ = 0;
+    pad_ = 0;
+    flushed_ = 0;
+    total_reserved_ = reserved_;
     clear_scratch();
   }
 
@@ -107,12 +141,14 @@ template<typename SizeT = uoffset_t> class vector_downward {
   }
 
   void clear_buffer() {
+    clear_chunks();
     if (buf_) Deallocate(allocator_, buf_, reserved_);
     buf_ = nullptr;
   }
 
   // Relinquish the pointer to the caller.
   uint8_t *release_raw(size_t &allocated_bytes, size_t &offset) {
+    flatten();
     auto *buf = buf_;
     allocated_bytes = reserved_;
     offset = vector_downward::offset();
@@ -126,6 +162,7 @@ template<typename SizeT = uoffset_t> class vector_downward {
 
   // Relinquish the pointer to the caller.
   DetachedBuffer release() {
+    flatten();
     // allocator ownership (if any) is transferred to DetachedBuffer.
     DetachedBuffer fb(allocator_, own_allocator_, buf_, reserved_, cur_,
                       size());
@@ -190,7 +227,101 @@ template<typename SizeT = uoffset_t> class vector_downward {
     return scratch_;
   }
 
-  uint8_t *data_at(size_t offset) const { return buf_ + reserved_ - offset; }
+  // The data at `offset`, which must be in the newest chunk, like the object
+  // under construction. Without chunks, `base_` and `pad_` are 0.
+  uint8_t *data_at(size_t offset) const {
+    FLATBUFFERS_ASSERT(!base_ || offset > base_);
+    return buf_ + reserved_ - pad_ - (offset - base_);
+  }
+
+  // The data at `offset`, which may be in any chunk.
+  uint8_t *chunked_data_at(size_t offset) const {
+    if (offset > base_) return data_at(offset);
+    // Flushed data is gone.
+    FLATBUFFERS_ASSERT(offset > flushed_);
+    return older_chunk_data_at(offset);
+  }
+
+  // Marks the start of a new object. In chunked mode, the data from here on
+  // is kept in a single chunk.
+  void mark_object() { mark_ = size_; }
+
+  // Enables or disables chunked mode, see above. Disabling it flattens the
+  // data, as growing without chunks needs it in a single buffer.
+  void set_chunked(bool chunked) {
+    FLATBUFFERS_ASSERT(FLATBUFFERS_GENERAL_HEAP_ALLOC_OK);
+    if (!chunked) flatten();
+    chunked_ = chunked;
+  }
+
+  // The number of chunks the data is spread over, 1 unless in chunked mode.
+  size_t num_chunks() const { return chunks_.size() + 1; }
+
+  // The data in chunk `i`, where chunk 0 holds the start of the data (the
+  // most recently written part), and the last chunk holds its end.
+  uint8_t *chunk(size_t i, size_t &len) const {
+    FLATBUFFERS_ASSERT(!flushed_);
+    if (!i) {
+      len = size_ - base_;
+      return cur_;
+    }
+    const Chunk &c = chunks_[chunks_.size() - i];
+    len = c.size;
+    return c.data;
+  }
+
+  // Copies all chunks into a single buffer, after which data() points to all
+  // of the data.
+  void flatten() {
+    if (!base_) return;
+    FLATBUFFERS_ASSERT(!flushed_);
+    const size_t scratch = scratch_size();
+    auto new_reserved = size_ + scratch;
+    new_reserved = (new_reserved + buffer_minalign_ - 1) &
+                   ~(buffer_minalign_ - 1);
+    auto new_buf = Allocate(allocator_, new_reserved);
+    auto dst = new_buf + new_reserved;
+    for (auto it = chunks_.begin(); it != chunks_.end(); ++it) {
+      dst -= it->size;
+      memcpy(dst, it->data, it->size);
+    }
+    clear_chunks();
+    const size_t used = size_ - base_;
+    dst -= used;
+    memcpy(dst, cur_, used);
+    memcpy(new_buf, buf_, scratch);
+    Deallocate(allocator_, buf_, reserved_);
+    buf_ = new_buf;
+    reserved_ = new_reserved;
+    total_reserved_ = reserved_;
+    cur_ = dst;
+    scratch_ = buf_ + scratch;
+    base_ = 0;
+    pad_ = 0;
+  }
+
+  // Passes all data to `sink(data, len)`, oldest (and thus last in the final
+  // buffer) first, and frees it. The current buffer is kept for the data that
+  // follows. Requires chunked mode and no object under construction.
+  template<typename SinkT> void flush(SinkT &sink) {
+    FLATBUFFERS_ASSERT(chunked_ && mark_ == size_);
+    for (auto it = chunks_.begin(); it != chunks_.end(); ++it) {
+      sink(it->data, static_cast<size_t>(it->size));
+    }
+    clear_chunks();
+    if (size_ > base_) {
+      sink(cur_, static_cast<size_t>(size_ - base_));
+    }
+    total_reserved_ = reserved_;
+    base_ = size_;
+    flushed_ = size_;
+    // Keep offsets aligned in memory, like start_chunk() does.
+    pad_ = size_ & (buffer_minalign_ - 1);
+    if (buf_) cur_ = buf_ + reserved_ - pad_;
+  }
+
+  // The number of bytes passed to flush() so far.
+  size_t flushed() const { return flushed_; }
 
   void push(const uint8_t *bytes, size_t num) {
     if (num > 0) { memcpy(make_space(num), bytes, num); }
@@ -222,6 +353,8 @@ template<typename SizeT = uoffset_t> class vector_downward {
   }
 
   void pop(size_t bytes_to_remove) {
+    // Data can only be popped from the newest chunk.
+    FLATBUFFERS_ASSERT(bytes_to_remove <= size_ - base_);
     cur_ += bytes_to_remove;
     size_ -= static_cast<SizeT>(bytes_to_remove);
   }
@@ -240,6 +373,13 @@ template<typename SizeT = uoffset_t> class vector_downward {
     swap(buf_, other.buf_);
     swap(cur_, other.cur_);
     swap(scratch_, other.scratch_);
+    swap(chunked_, other.chunked_);
+    swap(mark_, other.mark_);
+    swap(base_, other.base_);
+    swap(pad_, other.pad_);
+    swap(flushed_, other.flushed_);
+    swap(total_reserved_, other.total_reserved_);
+    swap(chunks_, other.chunks_);
   }
 
   void swap_allocator(vector_downward &other) {
@@ -266,7 +406,75 @@ template<typename SizeT = uoffset_t> class vector_downward {
   uint8_t *cur_;  // Points at location between empty (below) and used (above).
   uint8_t *scratch_;  // Points to the end of the scratchpad in use.
 
+  // A chunk holding older data, in chunked mode.
+  struct Chunk {
+    uint8_t *buf;
+    size_t reserved;
+    uint8_t *data;  // The lowest byte in use.
+    SizeT base;     // The bytes stored in older chunks.
+    SizeT size;     // The bytes in use in this chunk.
+  };
+
+  bool chunked_;
+  SizeT mark_;  // size() at the start of the object under construction.
+  SizeT base_;  // The bytes stored in older chunks, 0 if not chunked.
+  size_t pad_;  // Unused bytes at the top of buf_, to keep alignment.
+  SizeT flushed_;  // The bytes passed to flush(), no longer held.
+  size_t total_reserved_;      // The size of buf_ and all older chunks.
+  std::vector<Chunk> chunks_;  // Older chunks, oldest first.
+
+  uint8_t *older_chunk_data_at(size_t offset) const {
+    auto it = chunks_.end();
+    while (--it != chunks_.begin() && offset <= it->base) {}
+    return it->data + it->size - (offset - it->base);
+  }
+
+  void clear_chunks() {
+    for (auto it = chunks_.begin(); it != chunks_.end(); ++it) {
+      Deallocate(allocator_, it->buf, it->reserved);
+    }
+    chunks_.clear();
+  }
+
+  // Continues in a new chunk with room for `len` more bytes, moving the
+  // object under construction and the scratch-pad there.
+  void start_chunk(size_t len) {
+    FLATBUFFERS_ASSERT(mark_ >= base_ && mark_ <= size_);
+    const size_t partial = size_ - mark_;
+    const size_t scratch = scratch_size();
+    // Grow the total like reallocate() does.
+    auto new_reserved = len + partial + scratch + total_reserved_ / 2;
+    new_reserved = (new_reserved + buffer_minalign_ - 1) &
+                   ~(buffer_minalign_ - 1);
+    auto new_buf = Allocate(allocator_, new_reserved);
+    // Offsets are aligned relative to the end of the data, so the end of the
+    // data in this chunk is placed such that they are aligned in memory too.
+    const size_t pad = mark_ & (buffer_minalign_ - 1);
+    auto new_cur = new_buf + new_reserved - pad - partial;
+    memcpy(new_cur, cur_, partial);
+    memcpy(new_buf, buf_, scratch);
+    if (mark_ > base_) {
+      const Chunk c = { buf_, reserved_, cur_ + partial, base_,
+                        static_cast<SizeT>(mark_ - base_) };
+      chunks_.push_back(c);
+    } else {
+      Deallocate(allocator_, buf_, reserved_);
+      total_reserved_ -= reserved_;
+    }
+    buf_ = new_buf;
+    reserved_ = new_reserved;
+    total_reserved_ += new_reserved;
+    cur_ = new_cur;
+    scratch_ = buf_ + scratch;
+    base_ = mark_;
+    pad_ = pad;
+  }
+
   void reallocate(size_t len) {
+    if (chunked_ && buf_) {
+      start_chunk(len);
+      return;
+    }
     auto old_reserved = reserved_;
     auto old_size = size();
     auto old_scratch_size = scratch_size();
@@ -279,6 +487,7 @@ template<typename SizeT = uoffset_t> class vector_downward {
     } else {
       buf_ = Allocate(allocator_, reserved_);
     }
+    total_reserved_ = reserved_;
     cur_ = buf_ + reserved_ - old_size;
     scratch_ = buf_ + old_scratch_size;
   }
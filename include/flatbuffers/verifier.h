@@ -20,8 +20,70 @@
 #include "flatbuffers/base.h"
 #include "flatbuffers/vector.h"
 
+namespace flexbuffers {
+class SparseReuseTracker;
+}  // namespace flexbuffers
+
 namespace flatbuffers {
 
+// What a verification went through, see VerifierTemplate::SetStats().
+// Counters add up over all verifications done with the same stats.
+struct VerifierStats {
+  // Tables verified.
+  uoffset_t tables = 0;
+  // Vectors verified, strings included.
+  uoffset_t vectors = 0;
+  // Strings verified.
+  uoffset_t strings = 0;
+  // Bytes in the vtables, vectors and strings verified. Table fields are
+  // not counted.
+  size_t bytes = 0;
+  // The deepest nesting of tables reached, as limited by `max_depth`.
+  // Nested flatbuffers start over at zero.
+  uoffset_t max_depth = 0;
+  // Time spent in VerifyBuffer() and VerifySizePrefixedBuffer(), in the
+  // units of `clock`, if set.
+  uint64_t elapsed = 0;
+  // Returns the current time, to measure `elapsed` with. See
+  // verifier_stats.h for one based on std::chrono.
+  uint64_t (*clock)() = nullptr;
+
+  void Add(const VerifierStats &other) {
+    tables += other.tables;
+    vectors += other.vectors;
+    strings += other.strings;
+    bytes += other.bytes;
+    max_depth = (std::max)(max_depth, other.max_depth);
+    elapsed += other.elapsed;
+  }
+};
+
+// Runs parts of a verification on other threads, see
+// VerifierTemplate::SetExecutor() and VerifierThreadPool.
+class VerifierExecutor {
+ public:
+  virtual ~VerifierExecutor() {}
+
+  // The number of threads that run tasks, including the calling one.
+  virtual size_t Concurrency() const = 0;
+
+  // Calls `task(context, i)` for every `i` in [0, n), possibly concurrently,
+  // and returns once all calls are done. May be called from within a task.
+  virtual void ParallelFor(size_t n, void (*task)(void *context, size_t i),
+                           void *context) = 0;
+
+  // Like the above, calling `task(i)` on a function object or lambda.
+  template<typename F> void ParallelFor(size_t n, const F &task) {
+    ParallelFor(n, &CallTask<F>,
+                const_cast<void *>(static_cast<const void *>(&task)));
+  }
+
+ private:
+  template<typename F> static void CallTask(void *context, size_t i) {
+    (*static_cast<const F *>(context))(i);
+  }
+};
+
 // Helper class to verify the integrity of a FlatBuffer
 template <bool TrackVerifierBufferSize>
 class VerifierTemplate FLATBUFFERS_FINAL_CLASS {
@@ -33,6 +95,12 @@ class VerifierTemplate FLATBUFFERS_FINAL_CLASS {
     uoffset_t max_tables = 1000000;
     // If true, verify all data is aligned.
     bool check_alignment = true;
+    // If not 0, VerifyBuffer() and VerifySizePrefixedBuffer() also check that
+    // the buffer starts at an address that is a multiple of this, such as 8
+    // for a FlatBufferBuilder buffer or 4096 for an mmap()ed file. Alignment
+    // within the buffer is checked relative to its start, so this makes it
+    // hold for the actual addresses too.
+    size_t buffer_alignment = 0;
     // If true, run verifier on nested flatbuffers
     bool check_nested_flatbuffers = true;
     // The maximum size of a buffer.
@@ -43,8 +111,13 @@ class VerifierTemplate FLATBUFFERS_FINAL_CLASS {
 
   explicit VerifierTemplate(const uint8_t *const buf, const size_t buf_len,
                             const Options &opts)
-      : buf_(buf), size_(buf_len), opts_(opts) {
+      : buf_(buf),
+        size_(buf_len),
+        opts_(opts),
+        align_mask_(opts.check_alignment ? ~static_cast<size_t>(0) : 0) {
     FLATBUFFERS_ASSERT(size_ < opts.max_size);
+    FLATBUFFERS_ASSERT((opts.buffer_alignment & (opts.buffer_alignment - 1)) ==
+                       0);
   }
 
   // Deprecated API, please construct with VerifierTemplate::Options.
@@ -87,7 +160,16 @@ class VerifierTemplate FLATBUFFERS_FINAL_CLASS {
   }
 
   bool VerifyAlignment(const size_t elem, const size_t align) const {
-    return Check((elem & (align - 1)) == 0 || !opts_.check_alignment);
+    // `align` is a constant in generated code, and the mask stands in for
+    // `check_alignment`, so this is a single branch.
+    return Check((elem & (align - 1) & align_mask_) == 0);
+  }
+
+  // Verify the address the buffer starts at, see Options::buffer_alignment.
+  bool VerifyBufferAlignment() const {
+    const auto align = opts_.buffer_alignment;
+    return !align ||
+           Check((reinterpret_cast<uintptr_t>(buf_) & (align - 1)) == 0);
   }
 
   // Verify a range indicated by sizeof(T).
@@ -113,9 +195,27 @@ class VerifierTemplate FLATBUFFERS_FINAL_CLASS {
     return VerifyAlignment(f, align) && Verify(f, sizeof(T));
   }
 
+  // Verify the scalar and struct fields of a table in one go, see
+  // Table::VerifyInlineFields(). `slots` are the `num_slots` field offsets in
+  // its vtable.
+  template<size_t N>
+  bool VerifyInlineFields(const uint8_t *const table,
+                          const uint8_t *const slots, const size_t num_slots,
+                          const voffset_t (&sizes)[N],
+                          const voffset_t (&aligns)[N]) const {
+    const auto tableo = static_cast<size_t>(table - buf_);
+    // A compile-time count for the common case lets the loops unroll.
+    return num_slots >= N ? VerifyInlineFields(
+                                tableo, slots,
+                                std::integral_constant<size_t, N>(), sizes,
+                                aligns)
+                          : VerifyInlineFields(tableo, slots, num_slots,
+                                               sizes, aligns);
+  }
+
   // Verify a pointer (may be NULL) of a table type.
   template<typename T> bool VerifyTable(const T *const table) {
-    return !table || table->Verify(*this);
+    return !table || shallow_ || table->Verify(*this);
   }
 
   // Verify a pointer (may be NULL) of any vector type.
@@ -134,6 +234,7 @@ class VerifierTemplate FLATBUFFERS_FINAL_CLASS {
   // Verify a pointer (may be NULL) to string.
   bool VerifyString(const String *const str) const {
     size_t end;
+    if (stats_ && str) stats_->strings++;
     return !str || (VerifyVectorOrString<uoffset_t>(
                         reinterpret_cast<const uint8_t *>(str), 1, &end) &&
                     Verify(end, 1) &&           // Must have terminator
@@ -154,6 +255,10 @@ class VerifierTemplate FLATBUFFERS_FINAL_CLASS {
     if (!Check(size < max_elems))
       return false;  // Protect against byte_size overflowing.
     const auto byte_size = sizeof(LenT) + elem_size * size;
+    if (stats_) {
+      stats_->vectors++;
+      stats_->bytes += byte_size;
+    }
     if (end) *end = vec_offset + byte_size;
     return Verify(vec_offset, byte_size);
   }
@@ -171,7 +276,10 @@ class VerifierTemplate FLATBUFFERS_FINAL_CLASS {
   // Special case for table contents, after the above has been called.
   template<typename T>
   bool VerifyVectorOfTables(const Vector<Offset<T>> *const vec) {
-    if (vec) {
+    if (vec && !shallow_) {
+      if (executor_ && vec->size() >= 2 * kMinTablesPerTask) {
+        return VerifyVectorOfTablesParallel(vec);
+      }
       for (uoffset_t i = 0; i < vec->size(); i++) {
         if (!vec->Get(i)->Verify(*this)) return false;
       }
@@ -189,11 +297,9 @@ class VerifierTemplate FLATBUFFERS_FINAL_CLASS {
     const auto vtableo =
         tableo - static_cast<size_t>(ReadScalar<soffset_t>(table));
     // Check the vtable size field, then check vtable fits in its entirety.
-    if (!(VerifyComplexity() && Verify<voffset_t>(vtableo) &&
-          VerifyAlignment(ReadScalar<voffset_t>(buf_ + vtableo),
-                          sizeof(voffset_t))))
-      return false;
+    if (!(VerifyComplexity() && Verify<voffset_t>(vtableo))) return false;
     const auto vsize = ReadScalar<voffset_t>(buf_ + vtableo);
+    if (stats_) stats_->bytes += vsize;
     return Check((vsize & 1) == 0) && Verify(vtableo, vsize);
   }
 
@@ -226,7 +332,7 @@ class VerifierTemplate FLATBUFFERS_FINAL_CLASS {
   bool VerifyNestedFlatBuffer(const Vector<uint8_t, SizeT> *const buf,
                               const char *const identifier) {
     // Caller opted out of this.
-    if (!opts_.check_nested_flatbuffers) return true;
+    if (!opts_.check_nested_flatbuffers || shallow_) return true;
 
     // An empty buffer is OK as it indicates not present.
     if (!buf) return true;
@@ -236,19 +342,24 @@ class VerifierTemplate FLATBUFFERS_FINAL_CLASS {
 
     VerifierTemplate<TrackVerifierBufferSize> nested_verifier(
         buf->data(), buf->size(), opts_);
-    return nested_verifier.VerifyBuffer<T>(identifier);
+    nested_verifier.executor_ = executor_;
+    nested_verifier.stats_ = stats_;
+    // Not VerifyBuffer(), as the time is already counted.
+    return nested_verifier.VerifyBufferFromStart<T>(identifier, 0);
   }
 
   // Verify this whole buffer, starting with root type T.
   template<typename T> bool VerifyBuffer() { return VerifyBuffer<T>(nullptr); }
 
   template<typename T> bool VerifyBuffer(const char *const identifier) {
-    return VerifyBufferFromStart<T>(identifier, 0);
+    const StatsTimer timer(stats_);
+    return VerifyBufferAlignment() && VerifyBufferFromStart<T>(identifier, 0);
   }
 
   template<typename T, typename SizeT = uoffset_t>
   bool VerifySizePrefixedBuffer(const char *const identifier) {
-    return Verify<SizeT>(0U) &&
+    const StatsTimer timer(stats_);
+    return VerifyBufferAlignment() && Verify<SizeT>(0U) &&
            // Ensure the prefixed size is within the bounds of the provided
            // length.
            Check(ReadScalar<SizeT>(buf_) + sizeof(SizeT) <= size_) &&
@@ -280,6 +391,10 @@ class VerifierTemplate FLATBUFFERS_FINAL_CLASS {
   bool VerifyComplexity() {
     depth_++;
     num_tables_++;
+    if (stats_) {
+      stats_->tables++;
+      stats_->max_depth = (std::max)(stats_->max_depth, depth_);
+    }
     return Check(depth_ <= opts_.max_depth && num_tables_ <= opts_.max_tables);
   }
 
@@ -318,16 +433,144 @@ class VerifierTemplate FLATBUFFERS_FINAL_CLASS {
     flex_reuse_tracker_ = rt;
   }
 
+  flexbuffers::SparseReuseTracker *GetFlexSparseReuseTracker() {
+    return flex_sparse_reuse_tracker_;
+  }
+
+  // Tracks reuse in nested flexbuffers with `rt`, see
+  // flexbuffers::SparseReuseTracker. Takes precedence over
+  // SetFlexReuseTracker().
+  void SetFlexSparseReuseTracker(flexbuffers::SparseReuseTracker *const rt) {
+    flex_sparse_reuse_tracker_ = rt;
+  }
+
+  VerifierExecutor *GetExecutor() const { return executor_; }
+
+  // Verify large vectors of tables, in this buffer and any nested
+  // flatbuffers, in parallel on `executor` (not owned). Each task uses its
+  // own verifier, starting at the depth of the vector, and the tables they
+  // verify count towards `max_tables` as usual once they are done. Each
+  // task may verify up to the remaining `max_tables` before that.
+  // Tasks do not use the flex reuse tracker, as it is not thread-safe.
+  void SetExecutor(VerifierExecutor *const executor) { executor_ = executor; }
+
+  // Only verify the tables passed to Verify() (or the root table), not the
+  // tables, unions and nested flatbuffers they refer to. Their offsets are
+  // still checked to be inside the buffer, and so are strings, structs and
+  // vectors of those. See LazyVerifier.
+  void SetShallow(const bool shallow) { shallow_ = shallow; }
+
+  // Count what is verified into `stats` (not owned), or nothing if null, which
+  // costs a predictable branch per table, vector and string.
+  void SetStats(VerifierStats *const stats) { stats_ = stats; }
+
  private:
+  // Adds the time until its destruction to `stats`, if it has a clock.
+  class StatsTimer {
+   public:
+    explicit StatsTimer(VerifierStats *const stats)
+        : stats_(stats && stats->clock ? stats : nullptr),
+          start_(stats_ ? stats_->clock() : 0) {}
+    ~StatsTimer() {
+      if (stats_) stats_->elapsed += stats_->clock() - start_;
+    }
+
+   private:
+    VerifierStats *const stats_;
+    const uint64_t start_;
+  };
+
+  // The least number of tables verified by a single task.
+  static const uoffset_t kMinTablesPerTask = 1024;
+
+  template<typename T>
+  bool VerifyVectorOfTablesParallel(const Vector<Offset<T>> *const vec) {
+    const uoffset_t size = vec->size();
+    // A few tasks per thread, to balance tables of different sizes.
+    const uoffset_t num_tasks = static_cast<uoffset_t>((std::min)(
+        static_cast<size_t>(size / kMinTablesPerTask),
+        4 * executor_->Concurrency()));
+    Options task_opts = opts_;
+    task_opts.max_tables = opts_.max_tables - num_tables_;
+    std::vector<VerifierTemplate> tasks;
+    std::vector<VerifierStats> task_stats(stats_ ? num_tasks : 0);
+    tasks.reserve(num_tasks);
+    for (uoffset_t t = 0; t < num_tasks; t++) {
+      tasks.emplace_back(buf_, size_, task_opts);
+      tasks.back().depth_ = depth_;
+      tasks.back().executor_ = executor_;
+      if (stats_) tasks.back().stats_ = &task_stats[t];
+    }
+    std::vector<uint8_t> ok(num_tasks, 0);
+    executor_->ParallelFor(num_tasks, [&](size_t t) {
+      const auto begin = static_cast<uoffset_t>(size * t / num_tasks);
+      const auto end = static_cast<uoffset_t>(size * (t + 1) / num_tasks);
+      for (uoffset_t i = begin; i < end; i++) {
+        if (!vec->Get(i)->Verify(tasks[t])) return;
+      }
+      ok[t] = 1;
+    });
+    size_t num_tables = num_tables_;
+    for (uoffset_t t = 0; t < num_tasks; t++) {
+      if (!Check(ok[t] != 0)) return false;
+      num_tables += tasks[t].num_tables_;
+      if (stats_) stats_->Add(task_stats[t]);
+      if (TrackVerifierBufferSize) {
+        upper_bound_ = (std::max)(upper_bound_, tasks[t].upper_bound_);
+      }
+    }
+    if (!Check(num_tables <= opts_.max_tables)) return false;
+    num_tables_ = static_cast<uoffset_t>(num_tables);
+    return true;
+  }
+
+  template<typename CountT>
+  bool VerifyInlineFields(const size_t tableo, const uint8_t *const slots,
+                          const CountT num_slots, const voffset_t *const sizes,
+                          const voffset_t *const aligns) const {
+    if (opts_.check_alignment) {
+      // Only the low bits matter, so this is done on voffset_t, several
+      // fields at a time where the compiler vectorizes it.
+      const auto t = static_cast<voffset_t>(tableo);
+      voffset_t misaligned = 0;
+      for (size_t i = 0; i < num_slots; i++) {
+        const auto field =
+            ReadScalar<voffset_t>(slots + i * sizeof(voffset_t));
+        const voffset_t present = field ? 0xFFFF : 0;
+        misaligned |= static_cast<voffset_t>((t + field) & (aligns[i] - 1) &
+                                             present);
+      }
+      if (!Check(!misaligned)) return false;
+    }
+    // Field offsets and sizes are 16-bit, so if the table is far enough from
+    // the end of the buffer, all of its fields are inside it.
+    if (!TrackVerifierBufferSize && tableo + 2 * 0xFFFF < size_) return true;
+    // Otherwise, check where the fields actually end.
+    size_t extent = 0;
+    for (size_t i = 0; i < num_slots; i++) {
+      const size_t field =
+          ReadScalar<voffset_t>(slots + i * sizeof(voffset_t));
+      const size_t end = field + sizes[i];
+      if (field && sizes[i] && end > extent) extent = end;
+    }
+    return !extent || Verify(tableo, extent);
+  }
+
   const uint8_t *buf_;
   const size_t size_;
   const Options opts_;
+  // All ones if `check_alignment`, else 0.
+  const size_t align_mask_;
 
   mutable size_t upper_bound_ = 0;
 
   uoffset_t depth_ = 0;
   uoffset_t num_tables_ = 0;
   std::vector<uint8_t> *flex_reuse_tracker_ = nullptr;
+  flexbuffers::SparseReuseTracker *flex_sparse_reuse_tracker_ = nullptr;
+  VerifierExecutor *executor_ = nullptr;
+  bool shallow_ = false;
+  VerifierStats *stats_ = nullptr;
 };
 
 // Specialization for 64-bit offsets.
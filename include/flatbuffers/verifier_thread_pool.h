@@ -0,0 +1,140 @@
+/*
+ * Copyright 2024 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLATBUFFERS_VERIFIER_THREAD_POOL_H_
+#define FLATBUFFERS_VERIFIER_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "flatbuffers/base.h"
+#include "flatbuffers/verifier.h"
+
+namespace flatbuffers {
+
+// A fixed set of worker threads to verify buffers in parallel with:
+//
+//   VerifierThreadPool pool;
+//   Verifier verifier(buf, len);
+//   verifier.SetExecutor(&pool);
+//   bool ok = VerifyMonsterBuffer(verifier);
+//
+// The thread calling ParallelFor() works on its own tasks too, so tasks may
+// start more tasks without running out of threads. The pool may be shared by
+// several verifications at once.
+class VerifierThreadPool : public VerifierExecutor {
+ public:
+  // Starts `num_threads - 1` workers, as the calling thread makes up the last
+  // one. Defaults to one thread per core.
+  explicit VerifierThreadPool(size_t num_threads = 0) : stop_(false) {
+    if (!num_threads) num_threads = std::thread::hardware_concurrency();
+    for (size_t i = 1; i < num_threads; i++) {
+      workers_.emplace_back([this] { WorkerLoop(); });
+    }
+  }
+
+  ~VerifierThreadPool() FLATBUFFERS_OVERRIDE {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto &worker : workers_) worker.join();
+  }
+
+  size_t Concurrency() const FLATBUFFERS_OVERRIDE {
+    return workers_.size() + 1;
+  }
+
+  using VerifierExecutor::ParallelFor;
+
+  void ParallelFor(size_t n, void (*task)(void *context, size_t i),
+                   void *context) FLATBUFFERS_OVERRIDE {
+    if (workers_.empty() || n < 2) {
+      for (size_t i = 0; i < n; i++) task(context, i);
+      return;
+    }
+    Job job(n, task, context);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      jobs_.push_back(&job);
+    }
+    work_cv_.notify_all();
+    job.Run();
+    // All tasks have been claimed, wait for workers still running one.
+    std::unique_lock<std::mutex> lock(mutex_);
+    jobs_.erase(std::find(jobs_.begin(), jobs_.end(), &job));
+    done_cv_.wait(lock, [&] { return job.workers == 0; });
+  }
+
+ private:
+  // You shouldn't really be copying instances of this class.
+  FLATBUFFERS_DELETE_FUNC(VerifierThreadPool(const VerifierThreadPool &));
+  FLATBUFFERS_DELETE_FUNC(
+      VerifierThreadPool &operator=(const VerifierThreadPool &));
+
+  // A single ParallelFor() call, living on the stack of its caller.
+  struct Job {
+    Job(size_t n_, void (*task_)(void *, size_t), void *context_)
+        : n(n_), task(task_), context(context_), next(0), workers(0) {}
+
+    bool HasWork() const { return next.load(std::memory_order_relaxed) < n; }
+
+    void Run() {
+      for (size_t i = next++; i < n; i = next++) task(context, i);
+    }
+
+    const size_t n;
+    void (*const task)(void *, size_t);
+    void *const context;
+    std::atomic<size_t> next;  // The next task to claim.
+    size_t workers;            // Workers in Run(), guarded by `mutex_`.
+  };
+
+  Job *FindWork() const {
+    for (auto job : jobs_) {
+      if (job->HasWork()) return job;
+    }
+    return nullptr;
+  }
+
+  void WorkerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      Job *job = nullptr;
+      work_cv_.wait(lock, [&] { return stop_ || (job = FindWork()); });
+      if (stop_) return;
+      job->workers++;
+      lock.unlock();
+      job->Run();
+      lock.lock();
+      if (!--job->workers) done_cv_.notify_all();
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable work_cv_;
+  std::condition_variable done_cv_;
+  std::vector<Job *> jobs_;  // Jobs with tasks that may not be claimed yet.
+  bool stop_;
+};
+
+}  // namespace flatbuffers
+
+#endif  // FLATBUFFERS_VERIFIER_THREAD_POOL_H_
@@ -299,6 +299,9 @@ flatc(
         "--bfbs-gen-embed",
         "--bfbs-filenames",
         str(tests_path),
+        "--gen-packed-size",
+        "--gen-fast-verifier",
+        "--gen-table-view",
     ],
     include="include_test",
     schema="monster_test.fbs",
@@ -310,6 +313,11 @@ flatc(
     schema="arrays_test.fbs",
 )
 
+flatc(
+    BINARY_OPTS + ["--bfbs-filenames", str(tests_path)],
+    schema="union_underlying_type_test.fbs",
+)
+
 flatc(
     ["--jsonschema", "--schema"],
     include="include_test",
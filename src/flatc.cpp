@@ -114,6 +114,14 @@ const static FlatCOption flatc_options[] = {
     "Generate type name functions for C++ and Rust." },
   { "", "gen-object-api", "", "Generate an additional object-based API." },
   { "", "gen-compare", "", "Generate operator== for object-based API types." },
+  { "", "gen-packed-size", "",
+    "Generate GetPackedSizeUpperBound() for object-based API types." },
+  { "", "gen-fast-verifier", "",
+    "Generate C++ table verifiers that check all scalar and struct fields "
+    "with a single range check." },
+  { "", "gen-table-view", "",
+    "Generate a C++ View for each table that reads its vtable once, for "
+    "reading many fields of a table." },
   { "", "gen-nullable", "",
     "Add Clang _Nullable for C++ pointer. or @Nullable for Java" },
   { "", "java-package-prefix", "",
@@ -514,6 +522,12 @@ FlatCOptions FlatCompiler::ParseFromCommandLineArguments(int argc,
         opts.generate_object_based_api = true;
       } else if (arg == "--gen-compare") {
         opts.gen_compare = true;
+      } else if (arg == "--gen-packed-size") {
+        opts.gen_packed_size = true;
+      } else if (arg == "--gen-fast-verifier") {
+        opts.gen_fast_verifier = true;
+      } else if (arg == "--gen-table-view") {
+        opts.gen_table_view = true;
       } else if (arg == "--cpp-include") {
         if (++argi >= argc) Error("missing include following: " + arg, true);
         opts.cpp_includes.push_back(argv[argi]);
@@ -121,6 +121,11 @@ static void ForAllFieldsOrderedByOffset(
   }
 }
 
+// The bytes CreateString() adds besides the characters: the length, the
+// terminator, and padding to align the length.
+static const size_t kPackedStringOverhead =
+    sizeof(uoffset_t) + 1 + (sizeof(uoffset_t) - 1);
+
 class CppGenerator : public BaseGenerator {
  public:
   CppGenerator(const Parser &parser, const std::string &path,
@@ -506,6 +511,19 @@ class CppGenerator : public BaseGenerator {
       code_ += "";
     }
 
+    // Generate forward declarations for all packed size functions
+    if (opts_.generate_object_based_api && opts_.gen_packed_size) {
+      for (const auto &struct_def : parser_.structs_.vec) {
+        if (!struct_def->generated && !struct_def->fixed) {
+          SetNameSpace(struct_def->defined_namespace);
+          auto nativeName = NativeName(Name(*struct_def), struct_def, opts_);
+          code_ += "inline size_t GetPackedSizeUpperBound(const " + nativeName +
+                   " &_o);";
+        }
+      }
+      code_ += "";
+    }
+
     // Generate preablmle code for mini reflection.
     if (opts_.mini_reflect != IDLOptions::kNone) {
       // To break cyclic dependencies, first pre-declare all tables/structs.
@@ -1457,6 +1475,49 @@ class CppGenerator : public BaseGenerator {
     code_ += "";
 
     GenEnumEquals(enum_def);
+    GenUnionPackedSize(enum_def);
+  }
+
+  // Generates a GetPackedSizeUpperBound() for a native union type, that
+  // dispatches on the type of the value. The offset to the value is part of
+  // the bound of the table holding it.
+  void GenUnionPackedSize(const EnumDef &enum_def) {
+    if (!opts_.gen_packed_size) return;
+    code_ +=
+        "inline size_t GetPackedSizeUpperBound(const {{NAME}}Union &_u) {";
+    code_ += "  if (!_u.value) return 0;";
+    code_ += "  switch (_u.type) {";
+    for (const auto &ev : enum_def.Vals()) {
+      if (ev->IsZero()) { continue; }
+      code_.SetValue("NATIVE_ID", GetEnumValUse(enum_def, *ev));
+      code_.SetValue("NATIVE_TYPE", GetUnionElement(*ev, true, opts_));
+      code_ += "    case {{NATIVE_ID}}: {";
+      if (ev->union_type.base_type == BASE_TYPE_STRUCT) {
+        const auto &struct_def = *ev->union_type.struct_def;
+        if (struct_def.fixed) {
+          // The struct, and padding to align it.
+          code_ += "      return " +
+                   NumToString(struct_def.bytesize + struct_def.minalign - 1) +
+                   ";";
+        } else {
+          code_ +=
+              "      return GetPackedSizeUpperBound(*reinterpret_cast<const "
+              "{{NATIVE_TYPE}} *>(_u.value));";
+        }
+      } else if (IsString(ev->union_type)) {
+        code_ +=
+            "      return reinterpret_cast<const {{NATIVE_TYPE}} "
+            "*>(_u.value)->length() + " +
+            NumToString(kPackedStringOverhead) + ";";
+      } else {
+        FLATBUFFERS_ASSERT(false);
+      }
+      code_ += "    }";
+    }
+    code_ += "    default: return 0;";
+    code_ += "  }";
+    code_ += "}";
+    code_ += "";
   }
 
   void GenEnumEquals(const EnumDef &enum_def) {
@@ -2256,6 +2317,51 @@ class CppGenerator : public BaseGenerator {
     }
   }
 
+  // With --gen-fast-verifier, whether a field is checked by
+  // VerifyInlineFields() rather than on its own.
+  bool IsVerifiedInline(const FieldDef &field) const {
+    return !field.deprecated && !field.IsRequired() &&
+           (IsScalar(field.value.type.base_type) || IsStruct(field.value.type));
+  }
+
+  // Generate the size and alignment of the fields for VerifyInlineFields(),
+  // indexed by vtable slot. Returns false if there are no fields to verify
+  // this way.
+  bool GenInlineFieldLayout(const StructDef &struct_def) {
+    std::vector<std::string> sizes;
+    std::vector<std::string> aligns;
+    for (const auto &field : struct_def.fields.vec) {
+      if (!IsVerifiedInline(*field)) { continue; }
+      const size_t slot = field->value.offset / sizeof(voffset_t) - 2;
+      if (sizes.size() <= slot) {
+        sizes.resize(slot + 1, "0");
+        aligns.resize(slot + 1, "1");
+      }
+      sizes[slot] = NumToString(InlineSize(field->value.type));
+      aligns[slot] = NumToString(InlineAlignment(field->value.type));
+    }
+    if (sizes.empty()) { return false; }
+    GenVoffsetArray("kInlineSizes", sizes);
+    GenVoffsetArray("kInlineAligns", aligns);
+    return true;
+  }
+
+  void GenVoffsetArray(const std::string &name,
+                       const std::vector<std::string> &values) {
+    code_ += "    static const ::flatbuffers::voffset_t " + name + "[] = {";
+    std::string line = "     ";
+    for (size_t i = 0; i < values.size(); i++) {
+      const auto item = " " + values[i] + ",";
+      if (line.size() + item.size() > 80) {
+        code_ += line;
+        line = "     ";
+      }
+      line += item;
+    }
+    code_ += line;
+    code_ += "    };";
+  }
+
   // Generate the code to call the appropriate Verify function(s) for a field.
   void GenVerifyCall(const FieldDef &field, const char *prefix) {
     code_.SetValue("PRE", prefix);
@@ -2449,6 +2555,10 @@ class CppGenerator : public BaseGenerator {
           "    if ({{FIELD_NAME}}()->c_str() < _{{FIELD_NAME}}) return -1;";
       code_ += "    if (_{{FIELD_NAME}} < {{FIELD_NAME}}()->c_str()) return 1;";
       code_ += "    return 0;";
+      code_ += "  }";
+      // The key for Vector::LookupByKey() to compare strings with directly.
+      code_ += "  const ::flatbuffers::String *KeyString() const {";
+      code_ += "    return {{FIELD_NAME}}();";
     } else if (is_array) {
       const auto &elem_type = field.value.type.VectorType();
       std::string input_type = "::flatbuffers::Array<" +
@@ -2549,7 +2659,9 @@ class CppGenerator : public BaseGenerator {
     }
   }
 
-  void GenTableFieldGetter(const FieldDef &field) {
+  // Generate the getter of a field. The union getters by type are left out
+  // when `union_getters` is false.
+  void GenTableFieldGetter(const FieldDef &field, bool union_getters = true) {
     const auto &type = field.value.type;
     const auto offset_str = GenFieldOffsetName(field);
 
@@ -2595,7 +2707,40 @@ class CppGenerator : public BaseGenerator {
       code_ += "  }";
     }
 
-    if (type.base_type == BASE_TYPE_UNION) { GenTableUnionAsGetters(field); }
+    if (union_getters && type.base_type == BASE_TYPE_UNION) {
+      GenTableUnionAsGetters(field);
+    }
+  }
+
+  // With --gen-table-view, generate a View with the same getters as the
+  // table, that reads the field offsets out of the vtable once.
+  void GenTableView(const StructDef &struct_def) {
+    size_t num_slots = 0;
+    for (const auto &field : struct_def.fields.vec) {
+      const size_t slot = field->value.offset / sizeof(voffset_t) - 2;
+      num_slots = (std::max)(num_slots, slot + 1);
+    }
+    if (!num_slots) { return; }
+    code_.SetValue("NUM_SLOTS", NumToString(num_slots));
+    code_ += "  // Reads fields without going through the vtable each time, see";
+    code_ += "  // ::flatbuffers::TableView.";
+    code_ +=
+        "  class View : private "
+        "::flatbuffers::TableView<{{NUM_SLOTS}}> {";
+    code_ += "   public:";
+    code_ += "    explicit View(const {{STRUCT_NAME}} *table)";
+    code_ += "        : ::flatbuffers::TableView<{{NUM_SLOTS}}>(table) {}";
+    code_.SetPadding("  ");
+    code_.IncrementIdentLevel();
+    for (const auto &field : struct_def.fields.vec) {
+      if (field->deprecated) { continue; }
+      code_.SetValue("FIELD_NAME", Name(*field));
+      GenTableFieldGetter(*field, false);
+    }
+    code_.DecrementIdentLevel();
+    code_.SetPadding("");
+    code_ += "  };";
+    code_ += "  View GetView() const { return View(this); }";
   }
 
   void GenTableFieldType(const FieldDef &field) {
@@ -2881,12 +3026,22 @@ class CppGenerator : public BaseGenerator {
 
     if (opts_.cpp_static_reflection) { GenIndexBasedFieldGetter(struct_def); }
 
+    if (opts_.gen_table_view) { GenTableView(struct_def); }
+
     // Generate a verifier function that can check a buffer from an untrusted
     // source will never cause reads outside the buffer.
     code_ += "  bool Verify(::flatbuffers::Verifier &verifier) const {";
+    const bool verify_inline =
+        opts_.gen_fast_verifier && GenInlineFieldLayout(struct_def);
     code_ += "    return VerifyTableStart(verifier)\\";
+    if (verify_inline) {
+      code_ +=
+          " &&\n           VerifyInlineFields(verifier, kInlineSizes, "
+          "kInlineAligns)\\";
+    }
     for (const auto &field : struct_def.fields.vec) {
       if (field->deprecated) { continue; }
+      if (verify_inline && IsVerifiedInline(*field)) { continue; }
       GenVerifyCall(*field, " &&\n           ");
     }
 
@@ -3753,7 +3908,148 @@ class CppGenerator : public BaseGenerator {
       code_ += ");";
       code_ += "}";
       code_ += "";
+
+      if (opts_.gen_packed_size) GenPackedSizeUpperBound(struct_def);
+    }
+  }
+
+  // Generates GetPackedSizeUpperBound() for a native table type: an upper
+  // bound on the bytes that packing it adds to a builder, including room for
+  // Finish() in case it is the root. The parts of the table whose size does
+  // not depend on the object (fields, vtable, alignment) are summed up here,
+  // the generated code only adds strings, vectors and sub-objects.
+  //
+  // Every value is counted with padding to align it: at most one byte less
+  // than its alignment, as the builder aligns each value as it pushes it.
+  void GenPackedSizeUpperBound(const StructDef &struct_def) {
+    // The offset to the vtable that starts the table, and padding to align
+    // it.
+    const size_t vtable_offset = sizeof(soffset_t) + sizeof(soffset_t) - 1;
+    // The vtable, before its entries: its size and the table's size. The
+    // vtable is written in full before it may be deduplicated.
+    const size_t vtable_header = 2 * sizeof(voffset_t);
+    // The offset to the vtable, kept in the scratch-pad of the builder to
+    // deduplicate later vtables against.
+    const size_t vtable_dedup = sizeof(uoffset_t);
+    // Finish(): padding to align the buffer, the root offset, the file
+    // identifier and a size prefix. The padding is up to the alignment of the
+    // buffer, which is that of this table or one of its sub-objects, whose
+    // bounds include padding by their own alignment as well.
+    const size_t finish = struct_def.minalign - 1 + sizeof(uoffset_t) +
+                          flatbuffers::kFileIdentifierLength +
+                          sizeof(uoffset_t);
+    // While building the table, the builder keeps a FieldLoc in the
+    // scratch-pad for every field: the offset of the value, and the field's
+    // id padded to the size of that.
+    const size_t field_loc = 2 * sizeof(uoffset_t);
+    size_t fixed_size = vtable_offset + vtable_header + vtable_dedup + finish;
+    std::vector<std::string> terms;
+    for (const auto &field_ptr : struct_def.fields.vec) {
+      const auto &field = *field_ptr;
+      if (field.deprecated) { continue; }
+      const auto &type = field.value.type;
+      const std::string value = "_o." + Name(field);
+      // Each field has a vtable entry, and a FieldLoc.
+      fixed_size += sizeof(voffset_t) + field_loc;
+      // Offsets to other objects, and the padding to align them.
+      const size_t offset_size = field.offset64 ? 8 : 4;
+      switch (type.base_type) {
+        case BASE_TYPE_STRING: {
+          fixed_size += 2 * offset_size - 1;
+          terms.push_back("_size += " + value + ".length() + " +
+                          NumToString(kPackedStringOverhead) + ";");
+          break;
+        }
+        case BASE_TYPE_VECTOR64:
+        case BASE_TYPE_VECTOR: {
+          fixed_size += 2 * offset_size - 1;
+          const auto vtype = type.VectorType();
+          size_t elem_size = 4;
+          size_t align = 4;
+          if (IsStruct(vtype)) {
+            elem_size = vtype.struct_def->bytesize;
+            align = vtype.struct_def->minalign;
+          } else if (IsScalar(vtype.base_type)) {
+            elem_size = SizeOf(vtype.base_type);
+            align = elem_size;
+          }
+          const size_t prefix_size = type.base_type == BASE_TYPE_VECTOR64
+                                         ? sizeof(uoffset64_t)
+                                         : sizeof(uoffset_t);
+          const auto *force_align = field.attributes.Lookup("force_align");
+          if (force_align) {
+            align = (std::max)(
+                align, static_cast<size_t>(atoi(force_align->constant.c_str())));
+          }
+          // The length prefix and the elements, after padding to align both.
+          // The padding aligns the elements to the larger of the two, which
+          // takes at most one byte less than that.
+          align = (std::max)(align, prefix_size);
+          const std::string vec =
+              vtype.base_type == BASE_TYPE_UTYPE
+                  ? "_o." + StripUnionType(Name(field))
+                  : value;
+          terms.push_back("_size += " + vec + ".size() * " +
+                          NumToString(elem_size) + " + " +
+                          NumToString(prefix_size + align - 1) + ";");
+          if (IsString(vtype)) {
+            terms.push_back("for (const auto &_e : " + value + ") _size += " +
+                            "_e.length() + " +
+                            NumToString(kPackedStringOverhead) + ";");
+          } else if (vtype.base_type == BASE_TYPE_STRUCT && !IsStruct(vtype)) {
+            if (field.native_inline) {
+              terms.push_back("for (const auto &_e : " + value +
+                              ") _size += GetPackedSizeUpperBound(_e);");
+            } else {
+              // Null elements add nothing.
+              terms.push_back("for (const auto &_e : " + value + ") if (_e" +
+                              GenPtrGet(field) + ") _size += " +
+                              "GetPackedSizeUpperBound(*_e" +
+                              GenPtrGet(field) + ");");
+            }
+          } else if (vtype.base_type == BASE_TYPE_UNION) {
+            terms.push_back("for (const auto &_e : " + value +
+                            ") _size += GetPackedSizeUpperBound(_e);");
+          }
+          break;
+        }
+        case BASE_TYPE_UNION: {
+          fixed_size += 2 * offset_size - 1;
+          terms.push_back("_size += GetPackedSizeUpperBound(" + value + ");");
+          break;
+        }
+        case BASE_TYPE_STRUCT: {
+          if (IsStruct(type)) {
+            fixed_size +=
+                type.struct_def->bytesize + type.struct_def->minalign - 1;
+          } else if (field.native_inline) {
+            fixed_size += 2 * offset_size - 1;
+            terms.push_back("_size += GetPackedSizeUpperBound(" + value + ");");
+          } else {
+            fixed_size += 2 * offset_size - 1;
+            terms.push_back("if (" + value + ") _size += " +
+                            "GetPackedSizeUpperBound(*" + value +
+                            GenPtrGet(field) + ");");
+          }
+          break;
+        }
+        default: {
+          fixed_size += 2 * SizeOf(type.base_type) - 1;
+          break;
+        }
+      }
     }
+    code_.SetValue("NATIVE_NAME",
+                   NativeName(Name(struct_def), &struct_def, opts_));
+    code_.SetValue("FIXED_SIZE", NumToString(fixed_size));
+    code_ +=
+        "inline size_t GetPackedSizeUpperBound(const {{NATIVE_NAME}} &_o) {";
+    code_ += "  (void)_o;";
+    code_ += "  size_t _size = {{FIXED_SIZE}};";
+    for (const auto &term : terms) { code_ += "  " + term; }
+    code_ += "  return _size;";
+    code_ += "}";
+    code_ += "";
   }
 
   static void GenPadding(
@@ -765,4 +765,321 @@ bool VerifySizePrefixed(const reflection::Schema &schema,
                       /*required=*/true);
 }
 
+ReflectionVerifier::ReflectionVerifier(const reflection::Schema &schema)
+    : root_(-1),
+      file_ident_(schema.file_ident() ? schema.file_ident()->str() : "") {
+  const auto objects = schema.objects();
+  const auto enums = schema.enums();
+  unions_.resize(enums->size());
+  for (uoffset_t i = 0; i < enums->size(); i++) {
+    const auto enum_def = enums->Get(i);
+    if (!enum_def->is_union()) continue;
+    const auto values = enum_def->values();
+    bool sorted = false;
+    for (uoffset_t j = 0; j < values->size(); j++) {
+      const auto value = values->Get(j)->value();
+      if (value < 0 || value > 0xFF) sorted = true;
+    }
+    // Members by the value of their type, with gaps between values unknown,
+    // or just sorted by it if the values are too spread out for that.
+    const auto begin = static_cast<uint32_t>(members_.size());
+    for (uoffset_t j = 0; j < values->size(); j++) {
+      const auto value = values->Get(j);
+      UnionMember member = { UnionMember::kUnknown, 0, 1, value->value() };
+      const auto type = value->union_type();
+      if (!value->value() || !type) {
+        member.kind = UnionMember::kNone;
+      } else if (type->base_type() == reflection::String) {
+        member.kind = UnionMember::kString;
+      } else if (type->base_type() == reflection::Obj) {
+        const auto obj = objects->Get(type->index());
+        if (obj->is_struct()) {
+          member.kind = UnionMember::kStruct;
+          member.index = static_cast<uint32_t>(obj->bytesize());
+          member.align = static_cast<uint32_t>(obj->minalign());
+        } else {
+          member.kind = UnionMember::kTable;
+          member.index = static_cast<uint32_t>(type->index());
+        }
+      }
+      if (sorted) {
+        members_.push_back(member);
+        continue;
+      }
+      const size_t slot = begin + static_cast<size_t>(member.value);
+      while (members_.size() <= slot) {
+        const UnionMember unknown = { UnionMember::kUnknown, 0, 1,
+                                      static_cast<int64_t>(members_.size() -
+                                                           begin) };
+        members_.push_back(unknown);
+      }
+      members_[slot] = member;
+    }
+    if (sorted) {
+      std::sort(members_.begin() + begin, members_.end(),
+                [](const UnionMember &a, const UnionMember &b) {
+                  return a.value < b.value;
+                });
+    }
+    unions_[i].members = Range{ begin, static_cast<uint32_t>(members_.size()) };
+    unions_[i].type = enum_def->underlying_type()->base_type();
+    unions_[i].sorted = sorted;
+  }
+
+  tables_.resize(objects->size());
+  is_struct_.resize(objects->size());
+  for (uoffset_t i = 0; i < objects->size(); i++) {
+    const auto obj = objects->Get(i);
+    if (obj == schema.root_table()) root_ = static_cast<int32_t>(i);
+    is_struct_[i] = obj->is_struct();
+    const auto begin = static_cast<uint32_t>(ops_.size());
+    for (uoffset_t j = 0; !obj->is_struct() && j < obj->fields()->size();
+         j++) {
+      const auto field = obj->fields()->Get(j);
+      if (field->deprecated()) continue;
+      const auto type = field->type();
+      Op op;
+      op.kind = kScalar;
+      op.width = field->offset64() ? kOffset64 : k32;
+      op.required = field->required();
+      op.field = field->offset();
+      op.size = 0;
+      op.align = 1;
+      op.index = 0;
+      switch (type->base_type()) {
+        case reflection::String: op.kind = kString; break;
+        case reflection::Vector64:
+          op.width = kVector64;
+          FLATBUFFERS_FALLTHROUGH();
+        case reflection::Vector:
+          switch (type->element()) {
+            case reflection::String: op.kind = kVectorOfStrings; break;
+            case reflection::Union:
+              op.kind = kVectorOfUnions;
+              op.index = static_cast<uint32_t>(type->index());
+              break;
+            case reflection::Obj: {
+              const auto elem_obj = objects->Get(type->index());
+              if (elem_obj->is_struct()) {
+                op.kind = kVector;
+                op.size = static_cast<uint32_t>(elem_obj->bytesize());
+              } else {
+                op.kind = kVectorOfTables;
+                op.index = static_cast<uint32_t>(type->index());
+              }
+              break;
+            }
+            default:
+              op.kind = kVector;
+              op.size = static_cast<uint32_t>(GetTypeSize(type->element()));
+              break;
+          }
+          break;
+        case reflection::Obj: {
+          const auto child_obj = objects->Get(type->index());
+          if (child_obj->is_struct()) {
+            op.size = static_cast<uint32_t>(child_obj->bytesize());
+            op.align = static_cast<uint32_t>(child_obj->minalign());
+          } else {
+            op.kind = kTable;
+            op.index = static_cast<uint32_t>(type->index());
+          }
+          break;
+        }
+        case reflection::Union:
+          op.kind = kUnion;
+          op.index = static_cast<uint32_t>(type->index());
+          break;
+        default:
+          op.size = op.align =
+              static_cast<uint32_t>(GetTypeSize(type->base_type()));
+          break;
+      }
+      ops_.push_back(op);
+    }
+    tables_[i] = Range{ begin, static_cast<uint32_t>(ops_.size()) };
+  }
+}
+
+bool ReflectionVerifier::Verify(const uint8_t *const buf, const size_t length,
+                                const Verifier::Options &opts) const {
+  Verifier v(buf, length, opts);
+  return v.Check(root_ >= 0) &&
+         VerifyRoot(v, buf, length, static_cast<uoffset_t>(root_),
+                    file_ident_.empty() ? nullptr : file_ident_.c_str(), 0);
+}
+
+bool ReflectionVerifier::Verify(const uoffset_t object_index,
+                                const uint8_t *const buf, const size_t length,
+                                const Verifier::Options &opts) const {
+  Verifier v(buf, length, opts);
+  return VerifyRoot(v, buf, length, object_index, nullptr, 0);
+}
+
+bool ReflectionVerifier::VerifySizePrefixed(
+    const uint8_t *const buf, const size_t length,
+    const Verifier::Options &opts) const {
+  Verifier v(buf, length, opts);
+  return v.Check(root_ >= 0) && v.Verify<uoffset_t>(0) &&
+         v.Check(ReadScalar<uoffset_t>(buf) + sizeof(uoffset_t) <= length) &&
+         VerifyRoot(v, buf, length, static_cast<uoffset_t>(root_),
+                    file_ident_.empty() ? nullptr : file_ident_.c_str(),
+                    sizeof(uoffset_t));
+}
+
+bool ReflectionVerifier::VerifyRoot(Verifier &v, const uint8_t *const buf,
+                                    const size_t length,
+                                    const uoffset_t object_index,
+                                    const char *const identifier,
+                                    const size_t start) const {
+  if (!v.Check(object_index < tables_.size() && !is_struct_[object_index] &&
+               length - start >= FLATBUFFERS_MIN_BUFFER_SIZE)) {
+    return false;
+  }
+  if (identifier &&
+      !v.Check(length - start >= 2 * sizeof(uoffset_t) &&
+               BufferHasIdentifier(buf + start, identifier))) {
+    return false;
+  }
+  const size_t o = v.VerifyOffset<uoffset_t>(start);
+  return v.Check(o != 0) &&
+         VerifyTable(v, object_index,
+                     reinterpret_cast<const Table *>(buf + start + o));
+}
+
+bool ReflectionVerifier::VerifyTable(Verifier &v, const uint32_t index,
+                                     const Table *const table) const {
+  if (!table->VerifyTableStart(v)) return false;
+  const auto base = reinterpret_cast<const uint8_t *>(table);
+  const Range &range = tables_[index];
+  for (uint32_t i = range.begin; i < range.end; i++) {
+    const Op &op = ops_[i];
+    const voffset_t field_offset = table->GetOptionalFieldOffset(op.field);
+    if (!field_offset) {
+      if (!v.Check(!op.required)) return false;
+      continue;
+    }
+    if (op.kind == kScalar) {
+      if (!v.VerifyFieldStruct(base, field_offset, op.size, op.align)) {
+        return false;
+      }
+      continue;
+    }
+    // Everything else is an offset, to a string, vector, table or union.
+    const size_t o = op.width == k32
+                         ? v.VerifyOffset<uoffset_t>(base, field_offset)
+                         : v.VerifyOffset<uoffset64_t>(base, field_offset);
+    if (!o) return false;
+    const uint8_t *const p = base + field_offset + o;
+    switch (op.kind) {
+      case kString:
+        if (!v.VerifyString(reinterpret_cast<const String *>(p))) return false;
+        break;
+      case kVector:
+        if (!(op.width == kVector64
+                  ? v.VerifyVectorOrString<uoffset64_t>(p, op.size)
+                  : v.VerifyVectorOrString(p, op.size))) {
+          return false;
+        }
+        break;
+      case kVectorOfStrings: {
+        const auto vec = reinterpret_cast<const Vector<Offset<String>> *>(p);
+        if (!v.VerifyVector(vec) || !v.VerifyVectorOfStrings(vec)) {
+          return false;
+        }
+        break;
+      }
+      case kVectorOfTables: {
+        const auto vec = reinterpret_cast<const Vector<Offset<Table>> *>(p);
+        if (!v.VerifyVector(vec)) return false;
+        for (uoffset_t j = 0; j < vec->size(); j++) {
+          if (!VerifyTable(v, op.index, vec->Get(j))) return false;
+        }
+        break;
+      }
+      case kTable:
+        if (!VerifyTable(v, op.index, reinterpret_cast<const Table *>(p))) {
+          return false;
+        }
+        break;
+      case kUnion: {
+        // The type is the field before, which may not be verified yet. Like
+        // in generated code, it need not be aligned.
+        const reflection::BaseType type = unions_[op.index].type;
+        const voffset_t type_offset =
+            table->GetOptionalFieldOffset(op.field - sizeof(voffset_t));
+        if (type_offset && !v.VerifyFieldStruct(base, type_offset,
+                                                GetTypeSize(type), 1)) {
+          return false;
+        }
+        if (!VerifyUnion(v, op.index,
+                         type_offset ? GetAnyValueI(type, base + type_offset)
+                                     : 0,
+                         p)) {
+          return false;
+        }
+        break;
+      }
+      case kVectorOfUnions: {
+        const auto vec = reinterpret_cast<const Vector<Offset<uint8_t>> *>(p);
+        const voffset_t type_field = op.field - sizeof(voffset_t);
+        if (!v.VerifyVector(vec) ||
+            !table->VerifyOffsetRequired(v, type_field)) {
+          return false;
+        }
+        const reflection::BaseType type = unions_[op.index].type;
+        const size_t type_size = GetTypeSize(type);
+        const auto types = table->GetPointer<const uint8_t *>(type_field);
+        if (!v.VerifyVectorOrString(types, type_size) ||
+            !v.Check(ReadScalar<uoffset_t>(types) == vec->size())) {
+          return false;
+        }
+        const uint8_t *const type_data = types + sizeof(uoffset_t);
+        for (uoffset_t j = 0; j < vec->size(); j++) {
+          if (!VerifyUnion(v, op.index,
+                           GetAnyValueI(type, type_data + j * type_size),
+                           vec->Get(j))) {
+            return false;
+          }
+        }
+        break;
+      }
+      default: FLATBUFFERS_ASSERT(false); return false;
+    }
+  }
+  return v.EndTable();
+}
+
+bool ReflectionVerifier::VerifyUnion(Verifier &v, const uint32_t index,
+                                     const int64_t type,
+                                     const uint8_t *const value) const {
+  const Union &u = unions_[index];
+  const auto first = members_.begin() + u.members.begin;
+  const auto last = members_.begin() + u.members.end;
+  auto it = last;
+  if (u.sorted) {
+    it = std::lower_bound(
+        first, last, type,
+        [](const UnionMember &m, int64_t t) { return m.value < t; });
+    if (it != last && it->value != type) it = last;
+  } else if (type >= 0 && type < last - first) {
+    it = first + static_cast<ptrdiff_t>(type);
+  }
+  // Types from a newer schema are accepted, like generated code does.
+  if (it == last) return true;
+  const UnionMember &member = *it;
+  switch (member.kind) {
+    case UnionMember::kNone:
+    case UnionMember::kUnknown: return true;
+    case UnionMember::kTable:
+      return VerifyTable(v, member.index,
+                         reinterpret_cast<const Table *>(value));
+    case UnionMember::kStruct:
+      return v.VerifyFieldStruct(value, 0, member.index, member.align);
+    case UnionMember::kString:
+      return v.VerifyString(reinterpret_cast<const String *>(value));
+  }
+  return v.Check(false);
+}
+
 }  // namespace flatbuffers
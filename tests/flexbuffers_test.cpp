@@ -169,6 +169,397 @@ void FlexBuffersReuseBugTest() {
           true);
 }
 
+void FlexBuffersSparseReuseTrackerTest() {
+  // Enough maps with shared keys and strings for the tracker to grow.
+  flexbuffers::Builder slb(512, flexbuffers::BUILDER_FLAG_SHARE_ALL);
+  slb.Vector([&]() {
+    for (int i = 0; i < 100; i++) {
+      slb.Map([&]() {
+        slb.String("name", "item " + NumToString(i % 10));
+        slb.Int("id", i);
+        slb.Vector("tags", [&]() {
+          slb.String("shared");
+          slb.Blob(&i, sizeof(i));
+        });
+      });
+    }
+  });
+  slb.Finish();
+  std::vector<uint8_t> buf = slb.GetBuffer();
+
+  std::vector<uint8_t> reuse_tracker;
+  flexbuffers::SparseReuseTracker sparse_reuse_tracker;
+  // Each shared string used to count towards the nesting depth.
+  TEST_EQ(flexbuffers::VerifyBuffer(buf.data(), buf.size(), &reuse_tracker),
+          true);
+  TEST_EQ(flexbuffers::VerifyBuffer(buf.data(), buf.size(),
+                                    sparse_reuse_tracker),
+          true);
+
+  // Both trackers must agree, whatever is broken. They also reject objects
+  // used as different types, so they only pass what passes without one.
+  for (size_t i = 0; i < buf.size(); i += 7) {
+    const uint8_t original = buf[i];
+    buf[i] ^= 0x5A;
+    const bool ok =
+        flexbuffers::VerifyBuffer(buf.data(), buf.size(), &reuse_tracker);
+    TEST_EQ(flexbuffers::VerifyBuffer(buf.data(), buf.size(),
+                                      sparse_reuse_tracker),
+            ok);
+    if (ok) TEST_EQ(flexbuffers::VerifyBuffer(buf.data(), buf.size()), true);
+    buf[i] = original;
+  }
+}
+
+void FlexBuffersMapOrderTest() {
+  // Keys that differ in and past their first 8 bytes, including bytes that
+  // strcmp() orders after ASCII.
+  const std::vector<std::string> keys = { "b",         "",
+                                          "abcdefgh",  "abcdefg",
+                                          "abcdefghj", "abcdefghi",
+                                          "\xff",      "a\xff",
+                                          "abcdefgh\xff" };
+  std::vector<size_t> sorted(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) sorted[i] = i;
+  std::sort(sorted.begin(), sorted.end(), [&](size_t a, size_t b) {
+    return strcmp(keys[a].c_str(), keys[b].c_str()) < 0;
+  });
+  std::vector<size_t> reversed(sorted.rbegin(), sorted.rend());
+  std::vector<size_t> listed(sorted.size());
+  for (size_t i = 0; i < keys.size(); i++) listed[i] = i;
+
+  for (const auto flags : { flexbuffers::BUILDER_FLAG_NONE,
+                            flexbuffers::BUILDER_FLAG_SHARE_KEYS }) {
+    for (const auto order : { &sorted, &reversed, &listed }) {
+      flexbuffers::Builder slb(512, flags);
+      // Maps in the same order nested in each other, to see the order of
+      // one doesn't affect the others.
+      slb.Map([&]() {
+        for (const size_t i : *order) {
+          slb.Int(keys[i].c_str(), static_cast<int64_t>(i));
+        }
+        slb.Vector("zz", [&]() {
+          slb.Map([&]() {
+            for (const size_t i : *order) {
+              slb.Int(keys[i].c_str(), static_cast<int64_t>(i));
+            }
+          });
+        });
+      });
+      slb.Finish();
+      TEST_EQ(slb.HasDuplicateKeys(), false);
+      const auto outer = flexbuffers::GetRoot(slb.GetBuffer()).AsMap();
+      const auto inner = outer["zz"].AsVector()[0].AsMap();
+      TEST_EQ(outer.size(), keys.size() + 1);
+      TEST_EQ(inner.size(), keys.size());
+      for (size_t i = 0; i < keys.size(); i++) {
+        TEST_EQ_STR(inner.Keys()[i].AsKey(), keys[sorted[i]].c_str());
+        TEST_EQ(inner[keys[i]].AsInt64(), static_cast<int64_t>(i));
+        TEST_EQ(outer[keys[i]].AsInt64(), static_cast<int64_t>(i));
+      }
+    }
+  }
+
+  // Duplicate keys are found whether they are in order or not.
+  for (const auto flags : { flexbuffers::BUILDER_FLAG_NONE,
+                            flexbuffers::BUILDER_FLAG_SHARE_KEYS }) {
+    flexbuffers::Builder in_order(512, flags);
+    in_order.Map([&]() {
+      in_order.Int("a", 1);
+      in_order.Int("a", 2);
+    });
+    in_order.Finish();
+    TEST_EQ(in_order.HasDuplicateKeys(), true);
+    flexbuffers::Builder out_of_order(512, flags);
+    out_of_order.Map([&]() {
+      out_of_order.Int("abcdefghi", 1);
+      out_of_order.Int("a", 2);
+      out_of_order.Int("abcdefghi", 3);
+    });
+    out_of_order.Finish();
+    TEST_EQ(out_of_order.HasDuplicateKeys(), true);
+  }
+
+  // Keys as values, and in vectors, are not compared with the keys of the map
+  // they are in.
+  flexbuffers::Builder key_values(512, flexbuffers::BUILDER_FLAG_SHARE_KEYS);
+  key_values.Map([&]() {
+    key_values.Key("a");
+    key_values.Key("a");
+    key_values.Vector("b", [&]() {
+      key_values.Int(1);
+      key_values.Key("b");
+      key_values.Key("b");
+      key_values.Key("a");
+    });
+    key_values.Key("c");
+    key_values.Key("a");
+  });
+  key_values.Finish();
+  TEST_EQ(key_values.HasDuplicateKeys(), false);
+  const auto map = flexbuffers::GetRoot(key_values.GetBuffer()).AsMap();
+  TEST_EQ_STR(map["a"].AsKey(), "a");
+  TEST_EQ_STR(map["b"].AsVector()[3].AsKey(), "a");
+  TEST_EQ_STR(map["c"].AsKey(), "a");
+}
+
+void FlexBuffersShareKeyVectorsTest() {
+  // Maps with the same keys, in any order, with a blob between them so a
+  // shared keys vector ends up further away than a byte offset can reach.
+  const auto build = [](flexbuffers::Builder &slb) {
+    slb.Vector([&]() {
+      for (int i = 0; i < 10; i++) {
+        slb.Map([&]() {
+          slb.Int("id", i);
+          slb.String("name", "item " + NumToString(i));
+          if (i % 2) slb.Bool("odd", true);
+        });
+        slb.Map([&]() {
+          slb.String("name", "other");
+          slb.Int("id", -i);
+        });
+        if (i == 5) {
+          const std::vector<uint8_t> blob(100000, 0xAB);
+          slb.Blob(blob);
+        }
+      }
+    });
+    slb.Finish();
+  };
+  flexbuffers::Builder shared(512, flexbuffers::BUILDER_FLAG_SHARE_ALL);
+  build(shared);
+  flexbuffers::Builder unshared(
+      512, flexbuffers::BUILDER_FLAG_SHARE_KEYS_AND_STRINGS);
+  build(unshared);
+  const std::vector<uint8_t> &buf = shared.GetBuffer();
+  TEST_EQ(buf.size() < unshared.GetBuffer().size(), true);
+  std::vector<uint8_t> reuse_tracker;
+  TEST_EQ(flexbuffers::VerifyBuffer(buf.data(), buf.size(), &reuse_tracker),
+          true);
+  TEST_EQ(flexbuffers::VerifyBuffer(buf.data(), buf.size()), true);
+
+  // Reads the same as without sharing.
+  std::string text;
+  std::string unshared_text;
+  flexbuffers::GetRoot(buf).ToString(true, false, text);
+  flexbuffers::GetRoot(unshared.GetBuffer())
+      .ToString(true, false, unshared_text);
+  TEST_EQ_STR(text.c_str(), unshared_text.c_str());
+  const auto maps = flexbuffers::GetRoot(buf).AsVector();
+  for (size_t i = 0; i < maps.size(); i++) {
+    if (maps[i].IsBlob()) continue;
+    const auto map = maps[i].AsMap();
+    const bool other = map["name"].AsString().str() == "other";
+    TEST_EQ(map.size(), other || map["id"].AsInt64() % 2 == 0 ? 2U : 3U);
+    TEST_EQ(map["odd"].AsBool(), !other && map["id"].AsInt64() % 2 != 0);
+  }
+}
+
+void FlexBuffersSharePoolsTest() {
+  // Enough keys and strings for the pools to grow, some of which are equal up
+  // to their length, or hold a 0.
+  const char zeros[] = "a\0b\0a\0c";
+  const auto build = [&](flexbuffers::Builder &slb) {
+    slb.Vector([&]() {
+      for (int i = 0; i < 400; i++) {
+        slb.Map([&]() {
+          slb.Key("key" + NumToString(i % 200));
+          slb.String("str" + NumToString(i));
+          slb.String("", std::string(static_cast<size_t>(i % 3), 'x'));
+          slb.Key("z");
+          slb.String(zeros + 4 * (i % 2), 3);
+        });
+      }
+    });
+    slb.Finish();
+  };
+  flexbuffers::Builder slb(512, flexbuffers::BUILDER_FLAG_SHARE_ALL);
+  build(slb);
+  const std::vector<uint8_t> buf = slb.GetBuffer();
+  TEST_EQ(flexbuffers::VerifyBuffer(buf.data(), buf.size()), true);
+  const auto maps = flexbuffers::GetRoot(buf).AsVector();
+  TEST_EQ(maps.size(), 400U);
+  for (size_t i = 0; i < maps.size(); i++) {
+    const auto map = maps[i].AsMap();
+    const auto same_key = maps[i % 200].AsMap();
+    const auto same_len = maps[i % 3].AsMap();
+    const auto same_zeros = maps[i % 2].AsMap();
+    const auto key = "key" + NumToString(i % 200);
+    TEST_EQ_STR(map[key].AsString().c_str(), ("str" + NumToString(i)).c_str());
+    // Equal keys and strings are written once.
+    TEST_EQ(map.Keys()[1].AsKey(), same_key.Keys()[1].AsKey());
+    TEST_EQ(map.Keys()[0].AsKey(), maps[0].AsMap().Keys()[0].AsKey());
+    TEST_EQ(map[""].AsString().c_str(), same_len[""].AsString().c_str());
+    TEST_EQ(map[""].AsString().length(), i % 3);
+    TEST_EQ(map["z"].AsString().c_str(), same_zeros["z"].AsString().c_str());
+    TEST_EQ(map["z"].AsString().length(), 3U);
+    TEST_EQ(map["z"].AsString().c_str()[2], i % 2 ? 'c' : 'b');
+    if (i >= 200) {
+      TEST_EQ(map[key].AsString().c_str() != same_key[key].AsString().c_str(),
+              true);
+    }
+  }
+
+  // The pools are emptied by Clear(), so the same buffer is built again.
+  slb.Clear();
+  build(slb);
+  TEST_EQ(slb.GetBuffer() == buf, true);
+}
+
+void FlexBuffersMapKeyCacheTest() {
+  // Runs of maps of two shapes, so the keys vector changes now and then, and
+  // an empty map.
+  flexbuffers::Builder slb(512, flexbuffers::BUILDER_FLAG_SHARE_ALL);
+  slb.Vector([&]() {
+    for (int i = 0; i < 30; i++) {
+      slb.Map([&]() {
+        slb.Int("id", i);
+        if (i % 10 < 5) slb.String("name", "item " + NumToString(i));
+        for (int f = 0; f < 20; f++) slb.Int(("f" + NumToString(f)).c_str(), f);
+      });
+    }
+    slb.Map([]() {});
+  });
+  slb.Finish();
+  const std::vector<uint8_t> buf = slb.GetBuffer();
+  const auto maps = flexbuffers::GetRoot(buf).AsVector();
+
+  const char *keys[] = { "id", "name", "f0", "f19", "f7", "", "missing", "z" };
+  for (const char *key : keys) {
+    flexbuffers::MapKeyCache cache(key);
+    for (size_t i = 0; i < maps.size(); i++) {
+      const auto map = maps[i].AsMap();
+      const auto value = cache.Get(map);
+      TEST_EQ(value.IsNull(), map[key].IsNull());
+      TEST_EQ(value.ToString(), map[key].ToString());
+      const size_t index = map.KeyIndex(key);
+      if (index < map.Keys().size()) {
+        TEST_EQ_STR(map.Keys()[index].AsKey(), key);
+      } else {
+        TEST_EQ(index, map.Keys().size());
+        TEST_EQ(value.IsNull(), true);
+      }
+    }
+  }
+  // KeyCompare() reads a key through its offset, which is 3 bytes back here.
+  const uint8_t key_and_offset[] = { 'i', 'd', 0, 3 };
+  TEST_EQ(flexbuffers::KeyCompare<uint8_t>("id", key_and_offset + 3), 0);
+  TEST_EQ(flexbuffers::KeyCompare<uint8_t>("ia", key_and_offset + 3) < 0, true);
+  TEST_EQ(flexbuffers::KeyCompare<uint8_t>("name", key_and_offset + 3) > 0,
+          true);
+
+  flexbuffers::MapKeyCache name_cache(std::string("name"));
+  TEST_EQ_STR(name_cache.Get(maps[3].AsMap()).AsString().c_str(), "item 3");
+  TEST_EQ(name_cache.Get(maps[5].AsMap()).IsNull(), true);
+
+  // Another buffer, after Reset().
+  flexbuffers::Builder other(512, flexbuffers::BUILDER_FLAG_SHARE_ALL);
+  other.Map([&]() {
+    other.Int("a", 1);
+    other.Int("name", 2);
+  });
+  other.Finish();
+  name_cache.Reset();
+  TEST_EQ(name_cache.Get(flexbuffers::GetRoot(other.GetBuffer()).AsMap())
+              .AsInt64(),
+          2);
+}
+
+// Records the calls Walk() makes, one word each.
+struct RecordingVisitor : flexbuffers::Visitor {
+  void Null() { calls += "null "; }
+  void Bool(bool b) { calls += b ? "true " : "false "; }
+  void Int(int64_t i) { calls += "int:" + NumToString(i) + " "; }
+  void UInt(uint64_t u) { calls += "uint:" + NumToString(u) + " "; }
+  void Float(double d) { calls += "float:" + NumToString(d) + " "; }
+  void Key(const char *key) { calls += "key:" + std::string(key) + " "; }
+  void String(const char *str, size_t len) {
+    calls += "string:" + std::string(str, len) + " ";
+  }
+  void Blob(const uint8_t *, size_t len) {
+    calls += "blob:" + NumToString(len) + " ";
+  }
+  void StartVector(size_t size) { calls += "[" + NumToString(size) + " "; }
+  void EndVector() { calls += "] "; }
+  void StartMap(size_t size) { calls += "{" + NumToString(size) + " "; }
+  void MapKey(const char *key) { calls += std::string(key) + ": "; }
+  void EndMap() { calls += "} "; }
+  std::string calls;
+};
+
+void FlexBuffersWalkTest() {
+  flexbuffers::Builder slb;
+  slb.Map([&]() {
+    slb.Vector("vec", [&]() {
+      slb.Null();
+      slb.Int(-5);
+      slb.UInt(300);
+      slb.Double(2.5);
+      slb.Bool(true);
+      slb.IndirectInt(-70000);
+      slb.IndirectUInt(7);
+      slb.IndirectFloat(0.5f);
+      slb.String("str");
+      slb.Key("key");
+      const uint8_t blob[] = { 1, 2, 3 };
+      slb.Blob(blob, sizeof(blob));
+    });
+    const int64_t ints[] = { 1, -100000 };
+    slb.Vector("ints", ints, 2);
+    const bool bools[] = { false, true };
+    slb.Vector("bools", bools, 2);
+    const float floats[] = { 1.5f, -2.0f, 4.0f };
+    slb.FixedTypedVector("floats", floats, 3);
+    slb.TypedVector("keys", [&]() {
+      slb.Key("k1");
+      slb.Key("k2");
+    });
+    slb.Map("map", []() {});
+  });
+  slb.Finish();
+
+  RecordingVisitor visitor;
+  flexbuffers::Walk(slb.GetBuffer(), visitor);
+  TEST_EQ_STR(visitor.calls.c_str(),
+              "{6 bools: [2 false true ] floats: [3 float:1.5 float:-2.0 "
+              "float:4.0 ] ints: [2 int:1 int:-100000 ] keys: [2 key:k1 "
+              "key:k2 ] map: {0 } vec: [11 null int:-5 uint:300 float:2.5 "
+              "true int:-70000 uint:7 float:0.5 string:str key:key blob:3 ] "
+              "} ");
+
+  // A scalar root, and a Reference into the buffer.
+  RecordingVisitor vec_visitor;
+  flexbuffers::Walk(flexbuffers::GetRoot(slb.GetBuffer()).AsMap()["ints"],
+                    vec_visitor);
+  TEST_EQ_STR(vec_visitor.calls.c_str(), "[2 int:1 int:-100000 ] ");
+  flexbuffers::Builder scalar;
+  scalar.Int(42);
+  scalar.Finish();
+  RecordingVisitor scalar_visitor;
+  flexbuffers::Walk(scalar.GetBuffer().data(), scalar.GetBuffer().size(),
+                    scalar_visitor);
+  TEST_EQ_STR(scalar_visitor.calls.c_str(), "int:42 ");
+
+  // ToString() goes through Walk().
+  TEST_EQ_STR(flexbuffers::GetRoot(slb.GetBuffer()).ToString().c_str(),
+              "{ bools: [ false, true ], floats: [ 1.5, -2.0, 4.0 ], "
+              "ints: [ 1, -100000 ], keys: [ k1, k2 ], map: {  }, "
+              "vec: [ null, -5, 300, 2.5, true, -70000, 7, 0.5, \"str\", "
+              "key, \"\\u0001\\u0002\\u0003\" ] }");
+
+  // So does AppendToString(), one element at a time.
+  const auto root = flexbuffers::GetRoot(slb.GetBuffer()).AsMap();
+  std::string ints;
+  flexbuffers::AppendToString(ints, root["ints"].AsTypedVector(), false);
+  TEST_EQ_STR(ints.c_str(), "[ 1, -100000 ]");
+  std::string appended;
+  flexbuffers::AppendToString(appended, root["vec"].AsVector(), true, true, 1,
+                              "  ", false);
+  std::string indented;
+  root["vec"].ToString(true, true, indented, true, 0, "  ");
+  TEST_EQ_STR(appended.c_str(), indented.c_str());
+}
+
 void FlexBuffersFloatingPointTest() {
 #if defined(FLATBUFFERS_HAS_NEW_STRTOD) && (FLATBUFFERS_HAS_NEW_STRTOD > 0)
   flexbuffers::Builder slb(512,
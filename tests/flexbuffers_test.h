@@ -6,6 +6,12 @@ namespace tests {
 
 void FlexBuffersTest();
 void FlexBuffersReuseBugTest();
+void FlexBuffersSparseReuseTrackerTest();
+void FlexBuffersMapOrderTest();
+void FlexBuffersShareKeyVectorsTest();
+void FlexBuffersSharePoolsTest();
+void FlexBuffersMapKeyCacheTest();
+void FlexBuffersWalkTest();
 void FlexBuffersFloatingPointTest();
 void FlexBuffersDeprecatedTest();
 void ParseFlexbuffersFromJsonWithNullTest();
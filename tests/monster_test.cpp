@@ -197,6 +197,10 @@ void AccessFlatBufferTest(const uint8_t *flatbuf, size_t length, bool pooled) {
   std::vector<uint8_t> flex_reuse_tracker;
   verifier.SetFlexReuseTracker(&flex_reuse_tracker);
   TEST_EQ(VerifyMonsterBuffer(verifier), true);
+  flexbuffers::SparseReuseTracker flex_sparse_reuse_tracker;
+  flatbuffers::Verifier sparse_verifier(flatbuf, length);
+  sparse_verifier.SetFlexSparseReuseTracker(&flex_sparse_reuse_tracker);
+  TEST_EQ(VerifyMonsterBuffer(sparse_verifier), true);
 
   // clang-format off
   #ifdef FLATBUFFERS_TRACK_VERIFIER_BUFFER_SIZE
@@ -897,5 +901,142 @@ void UnPackTo(const uint8_t *flatbuf) {
   TEST_ASSERT(mon.enemy == nullptr);
 }
 
+void TableViewTest(const uint8_t *flatbuf) {
+  const Monster *monster = GetMonster(flatbuf);
+  const Monster::View view = monster->GetView();
+  TEST_EQ(view.pos(), monster->pos());
+  TEST_EQ(view.mana(), monster->mana());
+  TEST_EQ(view.hp(), monster->hp());
+  TEST_EQ_STR(view.name()->c_str(), "MyMonster");
+  TEST_EQ(view.inventory(), monster->inventory());
+  TEST_EQ(view.color(), monster->color());
+  TEST_EQ(view.test_type(), Any_Monster);
+  TEST_EQ(view.test(), monster->test());
+  TEST_EQ(view.test4(), monster->test4());
+  TEST_EQ(view.enemy(), monster->enemy());
+  TEST_EQ(view.testbool(), monster->testbool());
+  TEST_EQ(view.testf(), monster->testf());
+  TEST_EQ(view.vector_of_longs(), monster->vector_of_longs());
+  TEST_EQ(view.double_inf_default(), monster->double_inf_default());
+
+  // Views of the tables in a vector, with vtables of their own.
+  const auto tables = monster->testarrayoftables();
+  TEST_EQ(view.testarrayoftables(), tables);
+  for (uoffset_t i = 0; i < tables->size(); i++) {
+    const Monster::View element = tables->Get(i)->GetView();
+    TEST_EQ_STR(element.name()->c_str(), tables->Get(i)->name()->c_str());
+    TEST_EQ(element.hp(), tables->Get(i)->hp());
+    TEST_EQ(element.pos(), tables->Get(i)->pos());
+  }
+
+  // A vtable that ends before the last fields, as in data from an older
+  // schema, reads them as absent.
+  flatbuffers::FlatBufferBuilder builder;
+  builder.Finish(CreateStat(builder, builder.CreateString("older")));
+  const auto stat = flatbuffers::GetRoot<Stat>(builder.GetBufferPointer());
+  const auto data = reinterpret_cast<const uint8_t *>(stat);
+  const auto vtable =
+      data - flatbuffers::ReadScalar<flatbuffers::soffset_t>(data);
+  TEST_EQ(flatbuffers::ReadScalar<flatbuffers::voffset_t>(vtable),
+          static_cast<flatbuffers::voffset_t>(Stat::VT_VAL));
+  const Stat::View stat_view = stat->GetView();
+  TEST_EQ_STR(stat_view.id()->c_str(), "older");
+  TEST_EQ(stat_view.val(), 0);
+  TEST_EQ(stat_view.count(), 0);
+  const flatbuffers::TableView<3> raw(
+      reinterpret_cast<const flatbuffers::Table *>(stat));
+  TEST_EQ(raw.CheckField(Stat::VT_ID), true);
+  TEST_EQ(raw.CheckField(Stat::VT_VAL), false);
+  const auto val = raw.GetOptional<int64_t, int64_t>(Stat::VT_VAL);
+  TEST_EQ(val.has_value(), false);
+}
+
+namespace {
+// A table with a string key as older flatc generated it, without KeyString().
+struct KeyCompareOnlyMonster : private flatbuffers::Table {
+  int KeyCompareWithValue(const char *name) const {
+    return strcmp(GetPointer<const String *>(Monster::VT_NAME)->c_str(), name);
+  }
+  template<typename StringType>
+  int KeyCompareWithValue(const StringType &name) const {
+    return KeyCompareWithValue(name.c_str());
+  }
+};
+}  // namespace
+
+void LookupByKeyTest() {
+  // A key for every even number, with enough structs that the search
+  // prefetches.
+  const int num_tables = 20000;
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  std::vector<flatbuffers::Offset<Stat>> stats;
+  std::vector<Ability> abilities;
+  for (int i = 0; i < num_tables; i++) {
+    const std::string name = "m" + NumToString(2 * i);
+    monsters.push_back(CreateMonster(builder, nullptr, 150, 100,
+                                     builder.CreateString(name)));
+    stats.push_back(CreateStat(builder, 0, 0, static_cast<uint16_t>(2 * i)));
+    abilities.push_back(Ability(static_cast<uint32_t>(2 * i), 0));
+  }
+  const auto sorted_monsters = builder.CreateVectorOfSortedTables(&monsters);
+  const auto sorted_stats = builder.CreateVectorOfSortedTables(&stats);
+  const auto sorted_abilities =
+      builder.CreateVectorOfSortedStructs(&abilities);
+  const auto empty_name = builder.CreateString("empty");
+  const auto no_monsters = builder.CreateVector(monsters.data(), 0);
+  MonsterBuilder empty(builder);
+  empty.add_name(empty_name);
+  empty.add_testarrayoftables(no_monsters);
+  const auto enemy = empty.Finish();
+  const auto root_name = builder.CreateString("root");
+  MonsterBuilder root(builder);
+  root.add_name(root_name);
+  root.add_testarrayoftables(sorted_monsters);
+  root.add_scalar_key_sorted_tables(sorted_stats);
+  root.add_testarrayofsortedstruct(sorted_abilities);
+  root.add_enemy(enemy);
+  FinishMonsterBuffer(builder, root.Finish());
+  const Monster *monster = GetMonster(builder.GetBufferPointer());
+
+  const auto tables = monster->testarrayoftables();
+  const auto stat_tables = monster->scalar_key_sorted_tables();
+  const auto structs = monster->testarrayofsortedstruct();
+  for (int i = 0; i < 2 * num_tables + 1; i++) {
+    const std::string name = "m" + NumToString(i);
+    const Monster *found = tables->LookupByKey(name);
+    const bool present = i % 2 == 0 && i < 2 * num_tables;
+    TEST_EQ(found != nullptr, present);
+    if (found) TEST_EQ_STR(found->name()->c_str(), name.c_str());
+    TEST_EQ(tables->LookupByKey(name.c_str()), found);
+    const Stat *stat = stat_tables->LookupByKey(static_cast<uint16_t>(i));
+    TEST_EQ(stat != nullptr, present);
+    if (stat) TEST_EQ(stat->count(), i);
+    const Ability *ability = structs->LookupByKey(static_cast<uint32_t>(i));
+    TEST_EQ(ability != nullptr, present);
+    if (ability) TEST_EQ(ability->id(), static_cast<uint32_t>(i));
+  }
+  // Before the first key, between keys and after the last one.
+  TEST_NULL(tables->LookupByKey(""));
+  TEST_NULL(tables->LookupByKey("m"));
+  TEST_NULL(tables->LookupByKey("m00"));
+  TEST_NULL(tables->LookupByKey("z"));
+  TEST_NULL(stat_tables->LookupByKey(static_cast<uint16_t>(65535)));
+  TEST_NULL(structs->LookupByKey(static_cast<uint32_t>(1 << 30)));
+  // A key that only matches up to its end, or up to the end of the element.
+  TEST_NULL(tables->LookupByKey(std::string("m10\0", 4)));
+  TEST_NULL(tables->LookupByKey("m1"));
+  TEST_NULL(monster->enemy()->testarrayoftables()->LookupByKey("m0"));
+
+  // Elements without a KeyString() are still looked up by string.
+  const auto key_compare_only = reinterpret_cast<
+      const flatbuffers::Vector<flatbuffers::Offset<KeyCompareOnlyMonster>> *>(
+      tables);
+  TEST_EQ(reinterpret_cast<const void *>(key_compare_only->LookupByKey("m10")),
+          reinterpret_cast<const void *>(tables->LookupByKey("m10")));
+  TEST_NOTNULL(key_compare_only->LookupByKey(std::string("m12")));
+  TEST_NULL(key_compare_only->LookupByKey("m1"));
+}
+
 }  // namespace tests
 }  // namespace flatbuffers
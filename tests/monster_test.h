@@ -32,6 +32,10 @@ void ParseAndGenerateTextTest(const std::string& tests_data_path, bool binary);
 
 void UnPackTo(const uint8_t *flatbuf);
 
+void TableViewTest(const uint8_t *flatbuf);
+
+void LookupByKeyTest();
+
 }  // namespace tests
 }  // namespace flatbuffers
 
@@ -8,6 +8,7 @@
 #include "monster_test.h"
 #include "monster_test_generated.h"
 #include "test_assert.h"
+#include "union_underlying_type_test_generated.h"
 
 namespace flatbuffers {
 namespace tests {
@@ -249,6 +250,126 @@ void ReflectionTest(const std::string &tests_data_path, uint8_t *flatbuf,
           true);
 }
 
+void ReflectionVerifierTest(const std::string &tests_data_path,
+                            const uint8_t *flatbuf, size_t length) {
+  std::string bfbsfile;
+  TEST_EQ(flatbuffers::LoadFile((tests_data_path + "monster_test.bfbs").c_str(),
+                                true, &bfbsfile),
+          true);
+  const auto &schema = *reflection::GetSchema(bfbsfile.c_str());
+  const flatbuffers::ReflectionVerifier verifier(schema);
+  TEST_EQ(verifier.Verify(flatbuf, length), true);
+
+  // Any of the tables may be the root.
+  uoffset_t stat_index = 0;
+  while (strcmp(schema.objects()->Get(stat_index)->name()->c_str(),
+                "MyGame.Example.Stat")) {
+    stat_index++;
+  }
+  flatbuffers::FlatBufferBuilder fbb;
+  fbb.Finish(CreateStat(fbb, fbb.CreateString("stat"), 10, 1));
+  TEST_EQ(verifier.Verify(stat_index, fbb.GetBufferPointer(), fbb.GetSize()),
+          true);
+  TEST_EQ(verifier.Verify(schema.objects()->size(), fbb.GetBufferPointer(),
+                          fbb.GetSize()),
+          false);
+
+  fbb.Clear();
+  fbb.FinishSizePrefixed(
+      CopyTable(fbb, schema, *schema.root_table(), *GetAnyRoot(flatbuf)),
+      MonsterIdentifier());
+  TEST_EQ(verifier.VerifySizePrefixed(fbb.GetBufferPointer(), fbb.GetSize()),
+          true);
+  TEST_EQ(verifier.VerifySizePrefixed(fbb.GetBufferPointer(),
+                                      fbb.GetSize() - 1),
+          false);
+
+  // Broken buffers fail like they do with the generated verifier. Leave out
+  // nested flatbuffers and flexbuffers, which only that verifies.
+  MonsterT monster;
+  GetMonster(flatbuf)->UnPackTo(&monster);
+  monster.testnestedflatbuffer.clear();
+  monster.testrequirednestedflatbuffer.clear();
+  monster.flex.clear();
+  fbb.Clear();
+  FinishMonsterBuffer(fbb, Monster::Pack(fbb, &monster));
+  const std::vector<uint8_t> good(fbb.GetBufferPointer(),
+                                  fbb.GetBufferPointer() + fbb.GetSize());
+  std::vector<uint8_t> buf = good;
+  for (size_t i = 0; i < buf.size(); i++) {
+    for (int bit = 0; bit < 8; bit += 7) {
+      buf[i] ^= static_cast<uint8_t>(1 << bit);
+      flatbuffers::Verifier generated(buf.data(), buf.size());
+      TEST_EQ(verifier.Verify(buf.data(), buf.size()),
+              VerifyMonsterBuffer(generated));
+      buf[i] = good[i];
+    }
+  }
+  for (size_t len = 0; len < length; len++) {
+    flatbuffers::Verifier generated(flatbuf, len);
+    TEST_EQ(verifier.Verify(flatbuf, len), VerifyMonsterBuffer(generated));
+  }
+}
+
+void ReflectionVerifierUnionTypeTest(const std::string &tests_data_path) {
+  using namespace UnionUnderlyingType;
+  std::string bfbsfile;
+  TEST_EQ(flatbuffers::LoadFile(
+              (tests_data_path + "union_underlying_type_test.bfbs").c_str(),
+              true, &bfbsfile),
+          true);
+  const auto &schema = *reflection::GetSchema(bfbsfile.c_str());
+  const flatbuffers::ReflectionVerifier verifier(schema);
+  uoffset_t d_index = 0;
+  while (strcmp(schema.objects()->Get(d_index)->name()->c_str(),
+                "UnionUnderlyingType.D")) {
+    d_index++;
+  }
+
+  // The union types are ints, with values that do not fit in a byte.
+  DT d;
+  AT a;
+  a.a = 42;
+  BT b;
+  b.b = "foo";
+  CT c;
+  c.c = true;
+  d.test_union.Set(a);
+  d.test_vector_of_union.resize(3);
+  d.test_vector_of_union[0].Set(a);
+  d.test_vector_of_union[1].Set(b);
+  d.test_vector_of_union[2].Set(c);
+  flatbuffers::FlatBufferBuilder fbb;
+  fbb.Finish(D::Pack(fbb, &d));
+  std::vector<uint8_t> buf(fbb.GetBufferPointer(),
+                           fbb.GetBufferPointer() + fbb.GetSize());
+  TEST_EQ(verifier.Verify(d_index, buf.data(), buf.size()), true);
+
+  // Broken buffers fail like they do with the generated verifier.
+  const std::vector<uint8_t> good = buf;
+  for (size_t i = 0; i < buf.size(); i++) {
+    for (int bit = 0; bit < 8; bit += 7) {
+      buf[i] ^= static_cast<uint8_t>(1 << bit);
+      flatbuffers::Verifier generated(buf.data(), buf.size());
+      TEST_EQ(verifier.Verify(d_index, buf.data(), buf.size()),
+              generated.VerifyBuffer<D>(nullptr));
+      buf[i] = good[i];
+    }
+  }
+  for (size_t len = 0; len < buf.size(); len++) {
+    flatbuffers::Verifier generated(buf.data(), len);
+    TEST_EQ(verifier.Verify(d_index, buf.data(), len),
+            generated.VerifyBuffer<D>(nullptr));
+  }
+
+  // Types from a newer schema are accepted.
+  auto table = reinterpret_cast<Table *>(GetMutableRoot<D>(buf.data()));
+  TEST_EQ(table->SetField<int32_t>(D::VT_TEST_UNION_TYPE, 888, 0), true);
+  flatbuffers::Verifier generated(buf.data(), buf.size());
+  TEST_EQ(generated.VerifyBuffer<D>(nullptr), true);
+  TEST_EQ(verifier.Verify(d_index, buf.data(), buf.size()), true);
+}
+
 void MiniReflectFlatBuffersTest(uint8_t *flatbuf) {
   auto s =
       flatbuffers::FlatBufferToString(flatbuf, Monster::MiniReflectTypeTable());
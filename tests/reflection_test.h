@@ -8,6 +8,9 @@ namespace flatbuffers {
 namespace tests {
 
 void ReflectionTest(const std::string& tests_data_path, uint8_t *flatbuf, size_t length);
+void ReflectionVerifierTest(const std::string &tests_data_path,
+                            const uint8_t *flatbuf, size_t length);
+void ReflectionVerifierUnionTypeTest(const std::string &tests_data_path);
 void MiniReflectFixedLengthArrayTest();
 void MiniReflectFlatBuffersTest(uint8_t *flatbuf);
 
@@ -28,12 +28,18 @@
 
 #include "alignment_test.h"
 #include "evolution_test.h"
+#include "flatbuffers/arena_allocator.h"
+#include "flatbuffers/flatbuffer_builder_pool.h"
 #include "flatbuffers/flatbuffers.h"
 #include "flatbuffers/idl.h"
+#include "flatbuffers/lazy_verifier.h"
 #include "flatbuffers/minireflect.h"
 #include "flatbuffers/reflection_generated.h"
 #include "flatbuffers/registry.h"
+#include "flatbuffers/stream_verifier.h"
 #include "flatbuffers/util.h"
+#include "flatbuffers/verifier_stats.h"
+#include "flatbuffers/verifier_thread_pool.h"
 #include "fuzz_test.h"
 #include "json_test.h"
 #include "key_field_test.h"
@@ -432,6 +438,339 @@ void UninitializedVectorTest() {
   TEST_EQ(test_1->b(), 40);
 }
 
+// What VerifyInlineFields() replaces for TypeAliases.
+static bool VerifyTypeAliasesPerField(flatbuffers::Verifier &verifier,
+                                      const flatbuffers::Table *table) {
+  return table->VerifyTableStart(verifier) &&
+         table->VerifyField<int8_t>(verifier, TypeAliases::VT_I8, 1) &&
+         table->VerifyField<uint8_t>(verifier, TypeAliases::VT_U8, 1) &&
+         table->VerifyField<int16_t>(verifier, TypeAliases::VT_I16, 2) &&
+         table->VerifyField<uint16_t>(verifier, TypeAliases::VT_U16, 2) &&
+         table->VerifyField<int32_t>(verifier, TypeAliases::VT_I32, 4) &&
+         table->VerifyField<uint32_t>(verifier, TypeAliases::VT_U32, 4) &&
+         table->VerifyField<int64_t>(verifier, TypeAliases::VT_I64, 8) &&
+         table->VerifyField<uint64_t>(verifier, TypeAliases::VT_U64, 8) &&
+         table->VerifyField<float>(verifier, TypeAliases::VT_F32, 4) &&
+         table->VerifyField<double>(verifier, TypeAliases::VT_F64, 8) &&
+         verifier.EndTable();
+}
+
+void InlineFieldsVerifierTest() {
+  // With and without enough data after the table for the bounds check to be
+  // skipped.
+  for (size_t padding = 0; padding <= 200000; padding += 200000) {
+    flatbuffers::FlatBufferBuilder builder;
+    builder.CreateVector(std::vector<uint8_t>(padding));
+    builder.Finish(
+        CreateTypeAliases(builder, 1, 2, 3, 4, 5, 6, 7, 8, 9.0f, 10.0));
+    const std::vector<uint8_t> good(
+        builder.GetBufferPointer(),
+        builder.GetBufferPointer() + builder.GetSize());
+    const auto root_offset = static_cast<size_t>(
+        reinterpret_cast<const uint8_t *>(GetRoot<TypeAliases>(good.data())) -
+        good.data());
+    const auto vtable = reinterpret_cast<const flatbuffers::Table *>(
+                            GetRoot<TypeAliases>(good.data()))
+                            ->GetVTable();
+    const auto first_slot =
+        static_cast<size_t>(vtable - good.data()) + 2 * sizeof(uint16_t);
+
+    // Move each field by a few bytes, so it is misaligned or out of bounds,
+    // and cut the buffer short after the table: the single range check must
+    // agree with checking each field.
+    const uint16_t deltas[] = { 0, 1, 4, 0x100 };
+    for (size_t slot = 0; slot < 10; slot++) {
+      for (size_t d = 0; d < sizeof(deltas) / sizeof(deltas[0]); d++) {
+        std::vector<uint8_t> buf = good;
+        uint8_t *field = buf.data() + first_slot + slot * sizeof(uint16_t);
+        flatbuffers::WriteScalar<uint16_t>(
+            field, static_cast<uint16_t>(
+                       flatbuffers::ReadScalar<uint16_t>(field) + deltas[d]));
+        const auto root = GetRoot<TypeAliases>(buf.data());
+        const auto table = reinterpret_cast<const flatbuffers::Table *>(root);
+        for (size_t len = root_offset; len <= buf.size(); len++) {
+          if (len == root_offset + 128) len = buf.size();
+          for (int align = 0; align < 2; align++) {
+            flatbuffers::Verifier::Options opts;
+            opts.check_alignment = align != 0;
+            flatbuffers::Verifier fast(buf.data(), len, opts);
+            flatbuffers::Verifier slow(buf.data(), len, opts);
+            TEST_EQ(root->Verify(fast),
+                    VerifyTypeAliasesPerField(slow, table));
+          }
+        }
+      }
+    }
+  }
+}
+
+// Builds a monster with `n` children, and the same again nested inside it.
+std::vector<uint8_t> BuildManyMonsters(size_t n) {
+  std::vector<uint8_t> buf;
+  for (int level = 0; level < 2; level++) {
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector<flatbuffers::Offset<Monster>> children;
+    for (size_t i = 0; i < n; i++) {
+      const auto name = builder.CreateString(NumToString(i));
+      children.push_back(CreateMonster(builder, nullptr, 0, 0, name));
+    }
+    const auto nested = level ? builder.CreateVector(buf) : 0;
+    const auto name = builder.CreateString("parent");
+    const auto vec = builder.CreateVector(children);
+    auto monster_builder = MonsterBuilder(builder);
+    monster_builder.add_name(name);
+    monster_builder.add_testarrayoftables(vec);
+    monster_builder.add_testnestedflatbuffer(nested);
+    FinishMonsterBuffer(builder, monster_builder.Finish());
+    buf.assign(builder.GetBufferPointer(),
+               builder.GetBufferPointer() + builder.GetSize());
+  }
+  return buf;
+}
+
+void ParallelVerifierTest() {
+  const size_t n = 10000;
+  const std::vector<uint8_t> good = BuildManyMonsters(n);
+  flatbuffers::VerifierThreadPool pool(4);
+  TEST_EQ(pool.Concurrency(), 4u);
+
+  // Limits, and a child that is broken, must fail the same way as they do
+  // when verifying serially.
+  std::vector<uint8_t> bad = good;
+  const auto child = reinterpret_cast<const uint8_t *>(
+      GetMonster(bad.data())->testarrayoftables()->Get(n / 2));
+  flatbuffers::WriteScalar<flatbuffers::soffset_t>(
+      bad.data() + (child - bad.data()), 0x7FFFFFFF);
+  for (int broken = 0; broken < 2; broken++) {
+    const std::vector<uint8_t> &buf = broken ? bad : good;
+    for (flatbuffers::uoffset_t max_tables = n - 1; max_tables <= n + 1;
+         max_tables++) {
+      for (flatbuffers::uoffset_t max_depth = 1; max_depth <= 2; max_depth++) {
+        flatbuffers::Verifier::Options opts;
+        opts.max_tables = max_tables;
+        opts.max_depth = max_depth;
+        flatbuffers::Verifier serial(buf.data(), buf.size(), opts);
+        flatbuffers::Verifier parallel(buf.data(), buf.size(), opts);
+        parallel.SetExecutor(&pool);
+        const bool ok = !broken && max_tables > n && max_depth > 1;
+        TEST_EQ(VerifyMonsterBuffer(serial), ok);
+        TEST_EQ(VerifyMonsterBuffer(parallel), ok);
+      }
+    }
+  }
+}
+
+void LazyVerifierTest() {
+  const flatbuffers::uoffset_t n = 100;
+  const std::vector<uint8_t> good = BuildManyMonsters(n);
+  {
+    flatbuffers::LazyVerifier lazy(good.data(), good.size());
+    const Monster *root = lazy.GetRoot<Monster>(MonsterIdentifier());
+    TEST_NOTNULL(root);
+    TEST_EQ(lazy.NumTablesVerified(), 1u);
+    // Each table is verified once, when it is first read.
+    for (flatbuffers::uoffset_t i = 0; i < 3; i++) {
+      TEST_EQ(lazy.Get(root->testarrayoftables(), i),
+              root->testarrayoftables()->Get(i));
+    }
+    TEST_EQ(lazy.NumTablesVerified(), 4u);
+    TEST_NOTNULL(lazy.Get(root->testarrayoftables(), 1));
+    TEST_EQ(lazy.NumTablesVerified(), 4u);
+    TEST_ASSERT(!lazy.Get(root->testarrayoftables(), n));
+    TEST_ASSERT(!lazy.Get(root->enemy()));
+
+    // Nested flatbuffers get their own verifier.
+    const auto nested_buf = root->testnestedflatbuffer();
+    flatbuffers::LazyVerifier nested(nested_buf->data(), nested_buf->size());
+    const Monster *nested_root = nested.GetRoot<Monster>(MonsterIdentifier());
+    TEST_NOTNULL(nested_root);
+    TEST_EQ_STR(
+        nested.Get(nested_root->testarrayoftables(), 7)->name()->c_str(), "7");
+  }
+
+  // A broken table only fails once it is read.
+  std::vector<uint8_t> bad = good;
+  const auto child = reinterpret_cast<const uint8_t *>(
+      GetMonster(bad.data())->testarrayoftables()->Get(n / 2));
+  flatbuffers::WriteScalar<flatbuffers::soffset_t>(
+      bad.data() + (child - bad.data()), 0x7FFFFFFF);
+  flatbuffers::Verifier verifier(bad.data(), bad.size());
+  TEST_EQ(VerifyMonsterBuffer(verifier), false);
+  {
+    flatbuffers::LazyVerifier lazy(bad.data(), bad.size());
+    const Monster *root = lazy.GetRoot<Monster>(MonsterIdentifier());
+    TEST_NOTNULL(root);
+    TEST_NOTNULL(lazy.Get(root->testarrayoftables(), 0));
+    TEST_ASSERT(!lazy.Get(root->testarrayoftables(), n / 2));
+    TEST_ASSERT(!lazy.Get(root->testarrayoftables(), n / 2));
+  }
+
+  // `max_tables` counts all tables verified.
+  flatbuffers::Verifier::Options opts;
+  opts.max_tables = 2;
+  flatbuffers::LazyVerifier lazy(good.data(), good.size(), opts);
+  const Monster *root = lazy.GetRoot<Monster>(MonsterIdentifier());
+  TEST_NOTNULL(root);
+  TEST_NOTNULL(lazy.Get(root->testarrayoftables(), 0));
+  TEST_NOTNULL(lazy.Get(root->testarrayoftables(), 0));
+  TEST_ASSERT(!lazy.Get(root->testarrayoftables(), 1));
+}
+
+void VerifierStatsTest() {
+  const flatbuffers::uoffset_t n = 5000;
+  const std::vector<uint8_t> buf = BuildManyMonsters(n);
+  flatbuffers::VerifierThreadPool pool(4);
+  for (int parallel = 0; parallel < 2; parallel++) {
+    flatbuffers::VerifierStats stats;
+    stats.clock = flatbuffers::SteadyClockNanoseconds;
+    flatbuffers::Verifier verifier(buf.data(), buf.size());
+    verifier.SetStats(&stats);
+    if (parallel) verifier.SetExecutor(&pool);
+    TEST_EQ(VerifyMonsterBuffer(verifier), true);
+    // A parent with `n` children, in this buffer and the nested one.
+    TEST_EQ(stats.tables, 2 * (n + 1));
+    TEST_EQ(stats.strings, 2 * (n + 1));
+    // The children, nested flatbuffer and strings.
+    TEST_EQ(stats.vectors, 3 + stats.strings);
+    TEST_EQ(stats.max_depth, 2u);
+    // The nested flatbuffer is counted as a vector, and then again.
+    TEST_ASSERT(stats.bytes >
+                GetMonster(buf.data())->testnestedflatbuffer()->size());
+    TEST_ASSERT(stats.elapsed > 0);
+
+    // Stats add up over verifications.
+    TEST_EQ(VerifyMonsterBuffer(verifier), true);
+    TEST_EQ(stats.tables, 4 * (n + 1));
+  }
+}
+
+void StreamVerifierTest() {
+  // Back-to-back size prefixed monsters, with a broken one, and only the start
+  // of the last one.
+  const size_t n = 20;
+  std::vector<uint8_t> stream;
+  std::vector<size_t> offsets;
+  for (size_t i = 0; i <= n; i++) {
+    flatbuffers::FlatBufferBuilder builder;
+    FinishSizePrefixedMonsterBuffer(
+        builder, CreateMonster(builder, nullptr, 0, 0,
+                               builder.CreateString(NumToString(i))));
+    offsets.push_back(stream.size());
+    stream.insert(stream.end(), builder.GetBufferPointer(),
+                  builder.GetBufferPointer() + builder.GetSize());
+  }
+  const size_t complete = stream.size() - (stream.size() - offsets[n]) / 2;
+  stream.resize(complete);
+  stream[offsets[5] + 8] = 'X';  // Breaks the file identifier.
+
+  flatbuffers::VerifierThreadPool pool(4);
+  for (int parallel = 0; parallel < 2; parallel++) {
+    flatbuffers::SizePrefixedStreamVerifier<Monster> verifier(
+        MonsterIdentifier());
+    if (parallel) verifier.SetExecutor(&pool);
+    TEST_EQ(verifier.Verify(stream.data(), stream.size()), offsets[n]);
+    TEST_EQ(verifier.valid().size(), n - 1);
+    TEST_EQ(verifier.num_invalid(), 1u);
+    TEST_EQ(verifier.framed(), true);
+    for (size_t i = 0, v = 0; i < n; i++) {
+      if (i == 5) continue;
+      TEST_EQ(verifier.valid()[v++], offsets[i]);
+      TEST_EQ_STR(GetSizePrefixedMonster(stream.data() + offsets[i])
+                      ->name()
+                      ->c_str(),
+                  NumToString(i).c_str());
+    }
+    // Nothing but a partial buffer.
+    TEST_EQ(verifier.Verify(stream.data() + offsets[n], 3), 0u);
+    TEST_EQ(verifier.Verify(stream.data() + offsets[n],
+                            stream.size() - offsets[n]),
+            0u);
+    TEST_EQ(verifier.valid().size(), 0u);
+  }
+
+  // A size that can't be valid stops the stream.
+  std::vector<uint8_t> bad(stream.begin(), stream.begin() + offsets[2]);
+  flatbuffers::WriteScalar<flatbuffers::uoffset_t>(bad.data() + offsets[1],
+                                                   0xFFFFFFFF);
+  flatbuffers::SizePrefixedStreamVerifier<Monster> verifier;
+  TEST_EQ(verifier.Verify(bad.data(), bad.size()), offsets[1]);
+  TEST_EQ(verifier.valid().size(), 1u);
+  TEST_EQ(verifier.framed(), false);
+
+  // So does a 64-bit size that would wrap around when adding its own size.
+  std::vector<uint8_t> wrapping(16, 0);
+  flatbuffers::WriteScalar<flatbuffers::uoffset64_t>(
+      wrapping.data(), 0xFFFFFFFFFFFFFFFFULL - 7);
+  flatbuffers::SizePrefixedStreamVerifier<Monster, flatbuffers::uoffset64_t>
+      verifier64;
+  TEST_EQ(verifier64.Verify(wrapping.data(), wrapping.size()), 0u);
+  TEST_EQ(verifier64.valid().size(), 0u);
+  TEST_EQ(verifier64.num_invalid(), 0u);
+  TEST_EQ(verifier64.framed(), false);
+}
+
+void BufferAlignmentVerifierTest() {
+  flatbuffers::FlatBufferBuilder builder;
+  FinishSizePrefixedMonsterBuffer(
+      builder, CreateMonster(builder, nullptr, 0, 0,
+                             builder.CreateString("aligned")));
+  const size_t size = builder.GetSize();
+
+  // The buffer at an 8-byte aligned address. Without its size prefix, it
+  // starts at an address that is only 4-byte aligned.
+  std::vector<uint64_t> storage(size / 8 + 2);
+  uint8_t *const aligned = reinterpret_cast<uint8_t *>(&storage[1]);
+  memcpy(aligned, builder.GetBufferPointer(), size);
+  flatbuffers::Verifier::Options opts;
+  opts.buffer_alignment = 8;
+  flatbuffers::Verifier verifier(aligned, size, opts);
+  TEST_EQ(verifier.VerifySizePrefixedBuffer<Monster>(MonsterIdentifier()),
+          true);
+  flatbuffers::Verifier unprefixed(aligned + 4, size - 4, opts);
+  TEST_EQ(unprefixed.VerifyBuffer<Monster>(MonsterIdentifier()), false);
+
+  uint8_t *const misaligned = aligned - 4;
+  memmove(misaligned, aligned, size);
+  flatbuffers::Verifier checked(misaligned, size, opts);
+  TEST_EQ(checked.VerifySizePrefixedBuffer<Monster>(MonsterIdentifier()),
+          false);
+  // Alignment within the buffer is relative to its start, so that alone
+  // doesn't catch it.
+  flatbuffers::Verifier relative(misaligned, size);
+  TEST_EQ(relative.VerifySizePrefixedBuffer<Monster>(MonsterIdentifier()),
+          true);
+}
+
+void UninitializedStringTest() {
+  const std::string text = "read straight into the buffer";
+  for (int chunked = 0; chunked < 2; chunked++) {
+    // Small enough that adding the length after the contents grows the
+    // buffer, which `buf` has to account for.
+    flatbuffers::FlatBufferBuilder builder(32);
+    builder.ChunkedBuffer(chunked != 0);
+    builder.CreateString("x");
+    char *buf = nullptr;
+    auto name = builder.CreateUninitializedString(text.size(), &buf);
+    TEST_NOTNULL(buf);
+    memcpy(buf, text.data(), text.size());
+    auto empty = builder.CreateUninitializedString(0, &buf);
+    TEST_NOTNULL(buf);
+
+    auto monster_builder = MonsterBuilder(builder);
+    monster_builder.add_name(name);
+    FinishMonsterBuffer(builder, monster_builder.Finish());
+    builder.Flatten();
+
+    flatbuffers::Verifier verifier(builder.GetBufferPointer(),
+                                   builder.GetSize());
+    TEST_EQ(VerifyMonsterBuffer(verifier), true);
+    auto monster = GetMonster(builder.GetBufferPointer());
+    TEST_EQ_STR(monster->name()->c_str(), text.c_str());
+    TEST_EQ(flatbuffers::GetTemporaryPointer(builder, empty)->size(), 0u);
+    TEST_EQ_STR(flatbuffers::GetTemporaryPointer(builder, empty)->c_str(), "");
+  }
+}
+
 void EqualOperatorTest() {
   MonsterT a;
   MonsterT b;
@@ -596,6 +935,511 @@ void CreateSharedStringTest() {
   TEST_EQ((*a[6]) < (*a[5]), true);
 }
 
+// Counts the bytes handed out, to check where memory comes from.
+class CountingAllocator : public flatbuffers::DefaultAllocator {
+ public:
+  CountingAllocator() : allocated_(0) {}
+  uint8_t *allocate(size_t size) FLATBUFFERS_OVERRIDE {
+    allocated_ += size;
+    return flatbuffers::DefaultAllocator::allocate(size);
+  }
+  size_t allocated() const { return allocated_; }
+
+ private:
+  size_t allocated_;
+};
+
+void SharedStringPoolTest() {
+  CountingAllocator allocator;
+  flatbuffers::FlatBufferBuilder::StringPool pool(&allocator);
+  flatbuffers::FlatBufferBuilder builder;
+  builder.SetStringPool(&pool);
+
+  // Enough distinct strings to force the pool to grow a few times.
+  std::vector<flatbuffers::Offset<flatbuffers::String>> first, second;
+  for (int i = 0; i < 500; i++) {
+    first.push_back(builder.CreateSharedString(NumToString(i)));
+  }
+  const auto size_after_first = builder.GetSize();
+  for (int i = 0; i < 500; i++) {
+    second.push_back(builder.CreateSharedString(NumToString(i)));
+  }
+  // Hits must not write anything to the buffer.
+  TEST_EQ(builder.GetSize(), size_after_first);
+  for (size_t i = 0; i < first.size(); i++) {
+    TEST_EQ(first[i].o, second[i].o);
+  }
+  TEST_EQ(pool.size(), 500u);
+  TEST_ASSERT(allocator.allocated() > 0);
+
+  // The pool is emptied along with the builder, but keeps its slots.
+  const auto allocated = allocator.allocated();
+  builder.Clear();
+  TEST_EQ(pool.size(), 0u);
+  const auto one1 = builder.CreateSharedString("one");
+  const auto one2 = builder.CreateSharedString("one");
+  TEST_EQ(one1.o, one2.o);
+  TEST_EQ(allocator.allocated(), allocated);
+
+  // A pool can be handed to another builder once this one is done with it.
+  builder.SetStringPool(nullptr);
+  flatbuffers::FlatBufferBuilder other;
+  other.SetStringPool(&pool);
+  TEST_EQ(pool.size(), 0u);
+  const auto two1 = other.CreateSharedString("two");
+  const auto two2 = other.CreateSharedString("two");
+  TEST_EQ(two1.o, two2.o);
+  other.Finish(two1);
+  TEST_EQ_STR(
+      flatbuffers::GetRoot<flatbuffers::String>(other.GetBufferPointer())
+          ->c_str(),
+      "two");
+  other.SetStringPool(nullptr);
+}
+
+void BuilderPoolTest() {
+  CountingAllocator allocator;
+  flatbuffers::FlatBufferBuilderPool pool(2, 64, &allocator);
+  const std::string name(1000, 'x');
+  const flatbuffers::FlatBufferBuilder *first = nullptr;
+  {
+    auto builder = pool.Acquire();
+    first = builder.get();
+    builder->Finish(builder->CreateString(name));
+  }
+  // The buffer grew past the initial size, which the pool has noted.
+  TEST_ASSERT(pool.HighWaterMark() > name.size());
+  const auto allocated = allocator.allocated();
+  {
+    // The same builder comes back cleared, and building the same data again
+    // does not allocate.
+    auto builder = pool.Acquire();
+    TEST_ASSERT(builder.get() == first);
+    TEST_EQ(builder->GetSize(), 0u);
+    builder->Finish(builder->CreateString(name));
+    TEST_EQ_STR(flatbuffers::GetRoot<flatbuffers::String>(
+                    builder->GetBufferPointer())
+                    ->c_str(),
+                name.c_str());
+    TEST_EQ(allocator.allocated(), allocated);
+
+    // A builder that was never used before starts at the high-water mark.
+    auto second = pool.Acquire();
+    TEST_ASSERT(second.get() != first);
+    second->Finish(second->CreateString("y"));
+    TEST_ASSERT(allocator.allocated() - allocated >= pool.HighWaterMark());
+
+    // More builders than the pool holds still work.
+    auto overflow = pool.Acquire();
+    TEST_NOTNULL(overflow.get());
+    overflow->Finish(overflow->CreateString("z"));
+
+    // Released buffers are still counted in the high-water mark.
+    auto released = second.Release();
+    TEST_NOTNULL(released.data());
+  }
+}
+
+// Builds tables of `num_shapes` different layouts (each bit of the shape index
+// selects a field), so the hashed vtable index sees hits and misses.
+static flatbuffers::DetachedBuffer BuildManyVtables(bool hash_vtables,
+                                                    int num_shapes) {
+  flatbuffers::FlatBufferBuilder builder;
+  builder.HashVtables(hash_vtables);
+  std::vector<flatbuffers::Offset<flatbuffers::Table>> tables;
+  for (int i = 0; i < num_shapes * 3; i++) {
+    const int shape = i % num_shapes + 1;
+    const auto start = builder.StartTable();
+    for (int field = 0; field < 12; field++) {
+      if (shape & (1 << field)) {
+        builder.AddElement<uint8_t>(
+            flatbuffers::FieldIndexToOffset(static_cast<voffset_t>(field)),
+            static_cast<uint8_t>(i));
+      }
+    }
+    tables.push_back(builder.EndTable(start));
+  }
+  builder.Finish(builder.CreateVector(tables));
+  return builder.Release();
+}
+
+void HashVtablesTest() {
+  // Both dedup strategies must produce byte-identical buffers.
+  const auto linear = BuildManyVtables(false, 1000);
+  const auto hashed = BuildManyVtables(true, 1000);
+  TEST_EQ(linear.size(), hashed.size());
+  TEST_EQ(memcmp(linear.data(), hashed.data(), linear.size()), 0);
+
+  // The index must be reset along with the builder.
+  flatbuffers::FlatBufferBuilder builder;
+  builder.HashVtables(true);
+  for (int pass = 0; pass < 2; pass++) {
+    builder.Clear();
+    const auto start = builder.StartTable();
+    builder.AddElement<int32_t>(flatbuffers::FieldIndexToOffset(0), 42, 0);
+    const auto table = flatbuffers::Offset<flatbuffers::Table>(
+        builder.EndTable(start));
+    builder.Finish(table);
+    const auto root =
+        flatbuffers::GetRoot<flatbuffers::Table>(builder.GetBufferPointer());
+    TEST_EQ(root->GetField<int32_t>(flatbuffers::FieldIndexToOffset(0), 0),
+            42);
+  }
+}
+
+void ArenaAllocatorTest() {
+  CountingAllocator upstream;
+  flatbuffers::ArenaAllocator arena(8192, &upstream);
+  const std::string name(1000, 'x');
+  {
+    // A builder growing from a small initial size does so in place.
+    flatbuffers::FlatBufferBuilder builder(64, &arena);
+    builder.Finish(builder.CreateString(name));
+    TEST_EQ_STR(flatbuffers::GetRoot<flatbuffers::String>(
+                    builder.GetBufferPointer())
+                    ->c_str(),
+                name.c_str());
+    TEST_EQ(arena.num_chunks(), 1u);
+    TEST_EQ(upstream.allocated(), 8192u);
+  }
+  // The builder was the last allocation, so destroying it gave its memory back.
+  TEST_EQ(arena.bytes_used(), 0u);
+
+  // Buffers of several builders share the arena until it is reset.
+  {
+    std::vector<flatbuffers::DetachedBuffer> buffers;
+    for (int i = 0; i < 4; i++) {
+      flatbuffers::FlatBufferBuilder builder(256, &arena);
+      builder.Finish(builder.CreateString(NumToString(i)));
+      buffers.push_back(builder.Release());
+    }
+    for (int i = 0; i < 4; i++) {
+      TEST_EQ_STR(flatbuffers::GetRoot<flatbuffers::String>(buffers[i].data())
+                      ->c_str(),
+                  NumToString(i).c_str());
+    }
+    TEST_ASSERT(arena.bytes_used() >= 4 * 256u);
+  }
+  arena.reset();
+  TEST_EQ(arena.bytes_used(), 0u);
+
+  // Allocations larger than a chunk get a chunk of their own, and reset()
+  // keeps only the largest chunk.
+  {
+    flatbuffers::FlatBufferBuilder builder(20000, &arena);
+    builder.Finish(builder.CreateString(name));
+    TEST_EQ(arena.num_chunks(), 2u);
+  }
+  arena.reset();
+  TEST_EQ(arena.num_chunks(), 1u);
+  const auto allocated = upstream.allocated();
+  {
+    flatbuffers::FlatBufferBuilder builder(20000, &arena);
+    builder.Finish(builder.CreateString(name));
+  }
+  TEST_EQ(upstream.allocated(), allocated);
+  arena.release();
+  TEST_EQ(arena.num_chunks(), 0u);
+
+  // A caller owned buffer is used before going upstream.
+  alignas(16) uint8_t initial[512];
+  flatbuffers::ArenaAllocator stack_arena(initial, sizeof(initial), 1024,
+                                          &upstream);
+  {
+    flatbuffers::FlatBufferBuilder builder(256, &stack_arena);
+    builder.Finish(builder.CreateString("small"));
+    TEST_ASSERT(builder.GetBufferPointer() >= initial &&
+                builder.GetBufferPointer() < initial + sizeof(initial));
+    TEST_EQ(stack_arena.num_chunks(), 0u);
+  }
+  {
+    flatbuffers::FlatBufferBuilder builder(256, &stack_arena);
+    builder.Finish(builder.CreateString(name));
+    TEST_EQ(stack_arena.num_chunks(), 1u);
+  }
+
+  // After a reset, the initial buffer comes first again, so a larger chunk
+  // goes in front of the one kept. Resetting keeps the larger one, and the
+  // arena stops going upstream for requests of the same size.
+  const std::string large_name(5000, 'y');
+  size_t warm_allocated = 0;
+  for (int i = 0; i < 4; i++) {
+    stack_arena.reset();
+    {
+      flatbuffers::FlatBufferBuilder builder(256, &stack_arena);
+      builder.Finish(builder.CreateString(large_name));
+    }
+    if (i == 0) warm_allocated = upstream.allocated();
+    TEST_EQ(upstream.allocated(), warm_allocated);
+  }
+  stack_arena.reset();
+  TEST_EQ(stack_arena.num_chunks(), 1u);
+}
+
+// Builds enough monsters for a builder starting at 64 bytes to grow many
+// times, with shared strings and required fields read back during building.
+static void BuildChunkyMonsters(flatbuffers::FlatBufferBuilder &builder,
+                                bool sorted) {
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int i = 0; i < 300; i++) {
+    const auto name =
+        builder.CreateSharedString("monster" + NumToString(i % 50));
+    const std::vector<uint8_t> inventory(static_cast<size_t>(i * 7), 'i');
+    const auto inv = builder.CreateVector(inventory);
+    MonsterBuilder mb(builder);
+    mb.add_name(name);
+    mb.add_inventory(inv);
+    mb.add_hp(static_cast<int16_t>(i));
+    monsters.push_back(mb.Finish());
+  }
+  // A vector larger than any chunk so far.
+  const std::vector<uint8_t> big(100000, 'b');
+  const auto big_inv = builder.CreateVector(big);
+  const auto tables = sorted ? builder.CreateVectorOfSortedTables(&monsters)
+                             : builder.CreateVector(monsters);
+  const auto name = builder.CreateString("root");
+  MonsterBuilder mb(builder);
+  mb.add_name(name);
+  mb.add_inventory(big_inv);
+  mb.add_testarrayoftables(tables);
+  FinishMonsterBuffer(builder, mb.Finish());
+}
+
+void ChunkedBufferTest() {
+  for (int sorted = 0; sorted < 2; sorted++) {
+    flatbuffers::FlatBufferBuilder contiguous(64);
+    BuildChunkyMonsters(contiguous, sorted != 0);
+    const auto expected = contiguous.GetBufferSpan();
+
+    flatbuffers::FlatBufferBuilder chunked(64);
+    chunked.ChunkedBuffer(true);
+    BuildChunkyMonsters(chunked, sorted != 0);
+    TEST_EQ(chunked.GetSize(), contiguous.GetSize());
+
+    // The chunks make up the same bytes as the contiguous buffer.
+    std::vector<flatbuffers::span<const uint8_t>> chunks;
+    chunked.GetBufferChunks(chunks);
+    if (!sorted) TEST_ASSERT(chunks.size() > 1);
+    std::vector<uint8_t> joined;
+    for (size_t i = 0; i < chunks.size(); i++) {
+      joined.insert(joined.end(), chunks[i].data(),
+                    chunks[i].data() + chunks[i].size());
+    }
+    TEST_EQ(joined.size(), expected.size());
+    TEST_EQ(memcmp(joined.data(), expected.data(), joined.size()), 0);
+
+    const auto released = chunked.Release();
+    TEST_EQ(released.size(), expected.size());
+    TEST_EQ(memcmp(released.data(), expected.data(), released.size()), 0);
+    flatbuffers::Verifier verifier(released.data(), released.size());
+    TEST_EQ(VerifyMonsterBuffer(verifier), true);
+
+    // The builder keeps working after being released and cleared.
+    BuildChunkyMonsters(chunked, sorted != 0);
+    chunked.Flatten();
+    TEST_EQ(chunked.GetSize(), contiguous.GetSize());
+    TEST_EQ(memcmp(chunked.GetBufferPointer(), expected.data(),
+                   expected.size()),
+            0);
+  }
+
+  // Leaving chunked mode part way joins the chunks, so growing afterwards
+  // copies all of the data.
+  flatbuffers::FlatBufferBuilder contiguous(64);
+  flatbuffers::FlatBufferBuilder switched(64);
+  switched.ChunkedBuffer(true);
+  std::vector<flatbuffers::Offset<flatbuffers::String>> strings[2];
+  for (int i = 0; i < 200; i++) {
+    const std::string s = "string" + NumToString(i);
+    strings[0].push_back(contiguous.CreateString(s));
+    strings[1].push_back(switched.CreateString(s));
+  }
+  switched.ChunkedBuffer(false);
+  const std::vector<uint8_t> big(100000, 'b');
+  flatbuffers::FlatBufferBuilder *builders[2] = { &contiguous, &switched };
+  for (int i = 0; i < 2; i++) {
+    const auto inv = builders[i]->CreateVector(big);
+    const auto names = builders[i]->CreateVector(strings[i]);
+    const auto name = builders[i]->CreateString("root");
+    MonsterBuilder mb(*builders[i]);
+    mb.add_name(name);
+    mb.add_inventory(inv);
+    mb.add_testarrayofstring(names);
+    FinishMonsterBuffer(*builders[i], mb.Finish());
+  }
+  TEST_EQ(switched.GetSize(), contiguous.GetSize());
+  TEST_EQ(memcmp(switched.GetBufferPointer(), contiguous.GetBufferPointer(),
+                 contiguous.GetSize()),
+          0);
+}
+
+void PackedSizeTest(const uint8_t *flatbuf) {
+  std::unique_ptr<MonsterT> monster(GetMonster(flatbuf)->UnPack());
+  const size_t bound = GetPackedSizeUpperBound(*monster);
+
+  CountingAllocator allocator;
+  flatbuffers::FlatBufferBuilder builder(1, &allocator);
+  builder.Reserve(bound);
+  const auto allocated = allocator.allocated();
+  TEST_ASSERT(allocated >= bound);
+  FinishMonsterBuffer(builder, Monster::Pack(builder, monster.get()));
+  // Packing fit in the reserved space, so the buffer did not grow.
+  TEST_EQ(allocator.allocated(), allocated);
+  TEST_ASSERT(builder.GetSize() <= bound);
+
+  flatbuffers::Verifier verifier(builder.GetBufferPointer(),
+                                 builder.GetSize());
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+
+  // Null tables and union values add nothing besides their offsets.
+  monster->testarrayoftables.emplace_back();
+  TEST_EQ(GetPackedSizeUpperBound(*monster), bound + sizeof(uoffset_t));
+  AnyUnion empty;
+  empty.type = Any_Monster;
+  TEST_EQ(GetPackedSizeUpperBound(empty), 0u);
+}
+
+// Builds monsters the way a worker thread would, numbered from `first`.
+static std::vector<flatbuffers::Offset<Monster>> BuildWorkerMonsters(
+    flatbuffers::FlatBufferBuilder &builder, int first, int count) {
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int i = first; i < first + count; i++) {
+    const auto name = builder.CreateString("worker" + NumToString(i));
+    MonsterBuilder mb(builder);
+    mb.add_name(name);
+    mb.add_hp(static_cast<int16_t>(i));
+    monsters.push_back(mb.Finish());
+  }
+  return monsters;
+}
+
+void AppendSubBufferTest() {
+  const int kPerWorker = 100;
+  flatbuffers::FlatBufferBuilder builder;
+  // Something odd-sized first, so the workers' data needs realigning.
+  builder.CreateString("abc");
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int w = 0; w < 3; w++) {
+    flatbuffers::FlatBufferBuilder worker(64);
+    // Chunks are appended in order too.
+    worker.ChunkedBuffer(w == 1);
+    auto part = BuildWorkerMonsters(worker, w * kPerWorker, kPerWorker);
+    builder.AppendSubBuffer(worker, part);
+    monsters.insert(monsters.end(), part.begin(), part.end());
+  }
+
+  // A table built here now reuses the vtable the workers wrote, so it takes
+  // as much space as the second of two tables in a single builder.
+  flatbuffers::FlatBufferBuilder reference;
+  BuildWorkerMonsters(reference, 3 * kPerWorker, 1);
+  reference.CreateString("last");
+  const auto reference_size = reference.GetSize();
+  BuildWorkerMonsters(reference, 3 * kPerWorker, 1);
+  builder.CreateString("last");
+  const auto size = builder.GetSize();
+  const auto last = BuildWorkerMonsters(builder, 3 * kPerWorker, 1);
+  monsters.push_back(last[0]);
+  TEST_EQ(builder.GetSize() - size, reference.GetSize() - reference_size);
+
+  const auto name = builder.CreateString("root");
+  const auto tables = builder.CreateVector(monsters);
+  MonsterBuilder mb(builder);
+  mb.add_name(name);
+  mb.add_testarrayoftables(tables);
+  FinishMonsterBuffer(builder, mb.Finish());
+
+  flatbuffers::Verifier verifier(builder.GetBufferPointer(),
+                                 builder.GetSize());
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+  const auto result =
+      GetMonster(builder.GetBufferPointer())->testarrayoftables();
+  TEST_EQ(result->size(), 3u * kPerWorker + 1);
+  for (flatbuffers::uoffset_t i = 0; i < result->size(); i++) {
+    TEST_EQ(result->Get(i)->hp(), static_cast<int16_t>(i));
+    TEST_EQ_STR(result->Get(i)->name()->c_str(),
+                ("worker" + NumToString(i)).c_str());
+  }
+}
+
+void StreamingFlushTest() {
+  const int kBatches = 20;
+  const int kPerBatch = 50;
+  // The buffer comes out back to front.
+  std::vector<uint8_t> out;
+  auto sink = [&](const uint8_t *data, size_t len) {
+    out.insert(out.begin(), data, data + len);
+  };
+  flatbuffers::FlatBufferBuilder builder(256);
+  builder.ChunkedBuffer(true);
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int b = 0; b < kBatches; b++) {
+    auto batch = BuildWorkerMonsters(builder, b * kPerBatch, kPerBatch);
+    monsters.insert(monsters.end(), batch.begin(), batch.end());
+    builder.Flush(sink);
+    TEST_EQ(out.size(), builder.GetSize());
+  }
+  // Flushed objects can still be referred to.
+  const auto name = builder.CreateString("root");
+  const auto tables = builder.CreateVector(monsters);
+  MonsterBuilder mb(builder);
+  mb.add_name(name);
+  mb.add_testarrayoftables(tables);
+  FinishMonsterBuffer(builder, mb.Finish());
+  builder.Flush(sink);
+  TEST_EQ(out.size(), builder.GetSize());
+
+  flatbuffers::Verifier verifier(out.data(), out.size());
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+  const auto result = GetMonster(out.data())->testarrayoftables();
+  TEST_EQ(result->size(), static_cast<flatbuffers::uoffset_t>(kBatches) *
+                              kPerBatch);
+  for (flatbuffers::uoffset_t i = 0; i < result->size(); i++) {
+    TEST_EQ(result->Get(i)->hp(), static_cast<int16_t>(i));
+    TEST_EQ_STR(result->Get(i)->name()->c_str(),
+                ("worker" + NumToString(i)).c_str());
+  }
+}
+
+void BulkScalarVectorTest() {
+  // Odd lengths and an odd-sized start, so nothing lines up by accident.
+  const size_t kLen = 1001;
+  std::vector<int32_t> ints(kLen);
+  std::vector<int64_t> longs(kLen);
+  std::vector<bool> bools(kLen);
+  for (size_t i = 0; i < kLen; i++) {
+    ints[i] = static_cast<int32_t>(i * 2654435761u);
+    longs[i] = static_cast<int64_t>(i) * 100003 - 50000000;
+    bools[i] = i % 3 == 0 || i % 7 == 0;
+  }
+
+  flatbuffers::FlatBufferBuilder builder;
+  builder.CreateString("x");
+  const auto widened = builder.CreateVectorScalarCast<int64_t>(
+      flatbuffers::data(ints), kLen);
+  const auto narrowed = builder.CreateVectorScalarCast<int16_t>(
+      flatbuffers::data(longs), kLen);
+  const auto copied = builder.CreateVector(ints);
+  const auto packed = builder.CreateVector(bools);
+  const auto empty = builder.CreateVectorScalarCast<int64_t>(
+      flatbuffers::data(ints), 0);
+
+  auto w = flatbuffers::GetTemporaryPointer(builder, widened);
+  auto n = flatbuffers::GetTemporaryPointer(builder, narrowed);
+  auto c = flatbuffers::GetTemporaryPointer(builder, copied);
+  auto b = flatbuffers::GetTemporaryPointer(builder, packed);
+  TEST_EQ(w->size(), kLen);
+  TEST_EQ(n->size(), kLen);
+  TEST_EQ(c->size(), kLen);
+  TEST_EQ(b->size(), kLen);
+  for (flatbuffers::uoffset_t i = 0; i < kLen; i++) {
+    TEST_EQ(w->Get(i), static_cast<int64_t>(ints[i]));
+    TEST_EQ(n->Get(i), static_cast<int16_t>(longs[i]));
+    TEST_EQ(c->Get(i), ints[i]);
+    TEST_EQ(b->Get(i), bools[i] ? 1 : 0);
+  }
+  TEST_EQ(flatbuffers::GetTemporaryPointer(builder, empty)->size(), 0u);
+}
+
 #if !defined(FLATBUFFERS_USE_STD_SPAN) && !defined(FLATBUFFERS_SPAN_MINIMAL)
 void FlatbuffersSpanTest() {
   // Compile-time checking of non-const [] to const [] conversions.
@@ -1613,6 +2457,9 @@ int FlatBufferTests(const std::string &tests_data_path) {
 
   ObjectFlatBuffersTest(flatbuf.data());
   UnPackTo(flatbuf.data());
+  TableViewTest(flatbuf.data());
+  LookupByKeyTest();
+  PackedSizeTest(flatbuf.data());
 
   MiniReflectFlatBuffersTest(flatbuf.data());
   MiniReflectFixedLengthArrayTest();
@@ -1627,6 +2474,8 @@ int FlatBufferTests(const std::string &tests_data_path) {
   FixedLengthArrayJsonTest(tests_data_path, false);
   FixedLengthArrayJsonTest(tests_data_path, true);
   ReflectionTest(tests_data_path, flatbuf.data(), flatbuf.size());
+  ReflectionVerifierTest(tests_data_path, flatbuf.data(), flatbuf.size());
+  ReflectionVerifierUnionTypeTest(tests_data_path);
   ParseProtoTest(tests_data_path);
   EvolutionTest(tests_data_path);
   UnionDeprecationTest(tests_data_path);
@@ -1678,10 +2527,31 @@ int FlatBufferTests(const std::string &tests_data_path) {
   TypeAliasesTest();
   EndianSwapTest();
   CreateSharedStringTest();
+  SharedStringPoolTest();
+  HashVtablesTest();
+  BuilderPoolTest();
+  ArenaAllocatorTest();
+  ChunkedBufferTest();
+  AppendSubBufferTest();
+  BulkScalarVectorTest();
+  StreamingFlushTest();
   FlexBuffersTest();
   FlexBuffersReuseBugTest();
+  FlexBuffersSparseReuseTrackerTest();
+  FlexBuffersMapOrderTest();
+  FlexBuffersShareKeyVectorsTest();
+  FlexBuffersSharePoolsTest();
+  FlexBuffersMapKeyCacheTest();
+  FlexBuffersWalkTest();
   FlexBuffersDeprecatedTest();
   UninitializedVectorTest();
+  UninitializedStringTest();
+  InlineFieldsVerifierTest();
+  ParallelVerifierTest();
+  LazyVerifierTest();
+  VerifierStatsTest();
+  StreamVerifierTest();
+  BufferAlignmentVerifierTest();
   EqualOperatorTest();
   NumericUtilsTest();
   IsAsciiUtilsTest();